@@ -0,0 +1,220 @@
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* microbenchmark for the [hidio] event pipeline                             */
+/*                                                                           */
+/* hidio.c and hidio_linux.c are compiled into this file so that their       */
+/* static functions can be driven directly.  Synthetic struct input_events   */
+/* are fed to hidio_get_events() through a pipe standing in for the evdev    */
+/* file descriptor, opened with hidio_core_open_fd(), and the Pd API is      */
+/* provided by m_pd_stub.c.                                                  */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#ifndef __linux__
+#error "hidio_bench feeds struct input_event through a pipe, it needs Linux"
+#endif /* NOT __linux__ */
+
+#include <fcntl.h>
+#include <time.h>
+
+#include "../hidio.c"
+#include "../hidio_linux.c"
+
+#include "m_pd_stub.h"
+
+#define BENCH_DEVICE 0
+/* one tick per simulated millisecond, like [poll 1( */
+#define BENCH_TICK_MS 1
+#define BENCH_DEFAULT_TICKS 2000
+
+static unsigned short element_counts[] = {1, 8, 64, 500};
+static unsigned int event_rates[] = {1000, 10000, 100000};
+
+#define ARRAY_SIZE(a) (sizeof(a)/sizeof(a[0]))
+
+typedef struct _bench_result
+{
+    double nanoseconds;
+    unsigned long allocations;
+    unsigned long events;
+} t_bench_result;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void bench_result_add(t_bench_result *result, double start_ns,
+                             unsigned long start_allocations, unsigned long events)
+{
+    result->nanoseconds += now_ns() - start_ns;
+    result->allocations += stub_allocations - start_allocations;
+    result->events += events;
+}
+
+static void bench_result_print(const char *stage, unsigned short elements,
+                               unsigned int rate, t_bench_result *result)
+{
+    double events = result->events ? (double)result->events : 1.0;
+    printf("%-10s %8u %10u %10lu %12.1f %14.3f\n", stage, elements, rate,
+           result->events, result->nanoseconds / events,
+           (double)result->allocations / events);
+}
+
+/* fill the element tables of the core and of BENCH_DEVICE with count
+ * absolute axes */
+static void build_bench_elements(t_hidio *x, unsigned short count)
+{
+    char name[MAXPDSTRING];
+    t_hid_element *new_element;
+    unsigned short i;
+
+    for(i = 0; i < hidio_element_count[BENCH_DEVICE]; ++i)
+        freebytes(hidio_element_table[BENCH_DEVICE][i], sizeof(t_hid_element));
+    hidio_element_count[BENCH_DEVICE] = 0;
+    hidio_clear_element_values(BENCH_DEVICE);
+    x->x_core->num_elements = 0;
+    for(i = 0; i < count; ++i)
+    {
+        hidio_core_add_element(x->x_core, EV_ABS, i, 0, 255);
+        new_element = getbytes(sizeof(t_hid_element));
+        new_element->linux_type = EV_ABS;
+        new_element->linux_code = i;
+        new_element->type = ps_absolute;
+        snprintf(name, MAXPDSTRING, "bench_%d", i);
+        new_element->name = gensym(name);
+        new_element->min = 0;
+        new_element->max = 255;
+        SETSYMBOL(new_element->output_message, new_element->name);
+        SETFLOAT(new_element->output_message + 1, new_element->instance);
+        hidio_element_table[BENCH_DEVICE][hidio_element_count[BENCH_DEVICE]] = new_element;
+        ++hidio_element_count[BENCH_DEVICE];
+    }
+    hidio_build_element_index(BENCH_DEVICE);
+}
+
+/* the events of one tick, spread over all elements, each one a new value */
+static void make_tick_events(struct input_event *events, unsigned int count,
+                             unsigned short elements, unsigned long *serial)
+{
+    unsigned int i;
+    for(i = 0; i < count; ++i, ++*serial)
+    {
+        memset(events + i, 0, sizeof(struct input_event));
+        events[i].type = EV_ABS;
+        events[i].code = *serial % elements;
+        events[i].value = (*serial / elements) & 0xff;
+    }
+}
+
+static void run_bench(t_hidio *x, int *pipe_fds, unsigned short elements,
+                      unsigned int rate, unsigned int ticks)
+{
+    t_bench_result lookup, dispatch, tick, output;
+    unsigned int events_per_tick = rate * BENCH_TICK_MS / 1000;
+    struct input_event *events;
+    unsigned long serial = 0;
+    unsigned long start_allocations;
+    double start_ns;
+    unsigned int t, i;
+
+    if(events_per_tick < 1) events_per_tick = 1;
+    events = (struct input_event *)malloc(events_per_tick * sizeof(struct input_event));
+    memset(&lookup, 0, sizeof(t_bench_result));
+    memset(&dispatch, 0, sizeof(t_bench_result));
+    memset(&tick, 0, sizeof(t_bench_result));
+    memset(&output, 0, sizeof(t_bench_result));
+    build_bench_elements(x, elements);
+
+    for(t = 0; t < ticks; ++t)
+    {
+        make_tick_events(events, events_per_tick, elements, &serial);
+
+        /* element lookup: event type/code to t_hid_element */
+        start_allocations = stub_allocations;
+        start_ns = now_ns();
+        for(i = 0; i < events_per_tick; ++i)
+            find_element_by_type_code(x, events[i].type, events[i].code);
+        bench_result_add(&lookup, start_ns, start_allocations, events_per_tick);
+
+        /* per-event dispatch: hidio_get_events() reading from the "device" */
+        if(write(pipe_fds[1], events, events_per_tick * sizeof(struct input_event)) < 0)
+        {
+            perror("hidio_bench: write");
+            break;
+        }
+        stub_logical_time += BENCH_TICK_MS;
+        start_allocations = stub_allocations;
+        start_ns = now_ns();
+        hidio_get_events(x);
+        bench_result_add(&dispatch, start_ns, start_allocations, events_per_tick);
+
+        /* change detection: hidio_tick() without reading, since the events
+         * were already fetched at this logical time */
+        hidio_last_execute_time[BENCH_DEVICE] = stub_logical_time;
+        start_allocations = stub_allocations;
+        start_ns = now_ns();
+        hidio_tick(x);
+        bench_result_add(&tick, start_ns, start_allocations, events_per_tick);
+
+        /* atom building and outlet call for every element */
+        start_allocations = stub_allocations;
+        start_ns = now_ns();
+        for(i = 0; i < hidio_element_count[BENCH_DEVICE]; ++i)
+            hidio_output_event(x, hidio_element_table[BENCH_DEVICE][i]);
+        bench_result_add(&output, start_ns, start_allocations,
+                         hidio_element_count[BENCH_DEVICE]);
+    }
+    bench_result_print("lookup", elements, rate, &lookup);
+    bench_result_print("dispatch", elements, rate, &dispatch);
+    bench_result_print("tick", elements, rate, &tick);
+    bench_result_print("output", elements, rate, &output);
+    free(events);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int ticks = BENCH_DEFAULT_TICKS;
+    unsigned int e, r;
+    int pipe_fds[2];
+    t_hidio *x;
+
+    if(argc > 1)
+        ticks = (unsigned int)strtoul(argv[1], NULL, 10);
+    if(ticks < 1)
+        ticks = 1;
+
+    if(pipe(pipe_fds) < 0)
+    {
+        perror("hidio_bench: pipe");
+        return EXIT_FAILURE;
+    }
+    /* the largest tick (100 events) fits easily into the default pipe buffer */
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+    hidio_setup();
+    x = (t_hidio *)hidio_new(gensym("hidio"), 0, NULL);
+    x->x_device_number = BENCH_DEVICE;
+    x->x_core = hidio_core_open_fd(pipe_fds[0], BENCH_DEVICE);
+    x->x_device_open = 1;
+
+    printf("[hidio] event pipeline benchmark, %u ticks of %d ms per run\n\n",
+           ticks, BENCH_TICK_MS);
+    printf("%-10s %8s %10s %10s %12s %14s\n", "stage", "elements", "rate(Hz)",
+           "events", "ns/event", "allocs/event");
+    for(e = 0; e < ARRAY_SIZE(element_counts); ++e)
+    {
+        for(r = 0; r < ARRAY_SIZE(event_rates); ++r)
+        {
+            run_bench(x, pipe_fds, element_counts[e], event_rates[r], ticks);
+        }
+        printf("\n");
+    }
+
+    close(pipe_fds[1]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* minimal stand-in for Pd's m_pd.h, just enough of the API for [hidio]'s    */
+/* core to be compiled natively and driven by hidio_bench.c                  */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#ifndef __m_pd_h_
+#define __m_pd_h_
+
+#include <stddef.h>
+
+#define PD_MAJOR_VERSION 0
+#define PD_MINOR_VERSION 55
+
+#define MAXPDSTRING 1000
+#define MAXPDARG 5
+
+typedef long t_int;
+typedef float t_float;
+typedef float t_floatarg;
+typedef float t_sample;
+
+typedef struct _symbol
+{
+    const char *s_name;
+    struct _class **s_thing;
+    struct _symbol *s_next;
+} t_symbol;
+
+typedef enum
+{
+    A_NULL,
+    A_FLOAT,
+    A_SYMBOL,
+    A_POINTER,
+    A_SEMI,
+    A_COMMA,
+    A_DEFFLOAT,
+    A_DEFSYM,
+    A_DOLLAR,
+    A_DOLLSYM,
+    A_GIMME,
+    A_CANT
+} t_atomtype;
+
+typedef union word
+{
+    t_float w_float;
+    t_symbol *w_symbol;
+    int w_index;
+} t_word;
+
+typedef struct _atom
+{
+    t_atomtype a_type;
+    union word a_w;
+} t_atom;
+
+typedef struct _class t_class;
+typedef t_class *t_pd;
+typedef struct _outlet t_outlet;
+typedef struct _clock t_clock;
+
+typedef struct _gobj
+{
+    t_pd g_pd;
+    struct _gobj *g_next;
+} t_gobj;
+
+typedef struct _text
+{
+    t_gobj te_g;
+    void *te_binbuf;
+    t_outlet *te_outlet;
+    void *te_inlet;
+    short te_xpix;
+    short te_ypix;
+    short te_width;
+    unsigned int te_type:2;
+} t_object;
+
+typedef void (*t_method)(void);
+typedef void *(*t_newmethod)(void);
+typedef t_int *(*t_perfroutine)(t_int *args);
+
+typedef struct _signal t_signal;
+
+#define CLASS_DEFAULT 0
+
+#define SETSYMBOL(atom, s) ((atom)->a_type = A_SYMBOL, (atom)->a_w.w_symbol = (s))
+#define SETFLOAT(atom, f) ((atom)->a_type = A_FLOAT, (atom)->a_w.w_float = (f))
+
+extern t_symbol s_, s_float, s_list, s_bang, s_symbol;
+
+t_symbol *gensym(const char *s);
+
+void *getbytes(size_t nbytes);
+void *resizebytes(void *old, size_t oldsize, size_t newsize);
+void freebytes(void *x, size_t nbytes);
+
+void post(const char *fmt, ...);
+void error(const char *fmt, ...);
+void pd_error(const void *object, const char *fmt, ...);
+
+t_float atom_getfloat(const t_atom *a);
+t_int atom_getint(const t_atom *a);
+t_symbol *atom_getsymbol(const t_atom *a);
+t_float atom_getfloatarg(int which, int argc, const t_atom *argv);
+t_int atom_getintarg(int which, int argc, const t_atom *argv);
+t_symbol *atom_getsymbolarg(int which, int argc, const t_atom *argv);
+void atom_string(const t_atom *a, char *buf, unsigned int bufsize);
+
+t_outlet *outlet_new(t_object *owner, t_symbol *s);
+void outlet_bang(t_outlet *x);
+void outlet_float(t_outlet *x, t_float f);
+void outlet_symbol(t_outlet *x, t_symbol *s);
+void outlet_list(t_outlet *x, t_symbol *s, int argc, t_atom *argv);
+void outlet_anything(t_outlet *x, t_symbol *s, int argc, t_atom *argv);
+void outlet_free(t_outlet *x);
+
+t_clock *clock_new(void *owner, t_method fn);
+void clock_set(t_clock *x, double systime);
+void clock_delay(t_clock *x, double delaytime);
+void clock_unset(t_clock *x);
+void clock_free(t_clock *x);
+double clock_getlogicaltime(void);
+double clock_gettimesince(double prevsystime);
+
+t_class *class_new(t_symbol *name, t_newmethod newmethod, t_method freemethod,
+                   size_t size, int flags, t_atomtype arg1, ...);
+void class_addmethod(t_class *c, t_method fn, t_symbol *sel,
+                     t_atomtype arg1, ...);
+void class_addbang(t_class *c, t_method fn);
+void class_addfloat(t_class *c, t_method fn);
+void class_addanything(t_class *c, t_method fn);
+t_pd *pd_new(t_class *cls);
+void pd_float(t_pd *x, t_float f);
+
+void dsp_add(t_perfroutine f, int n, ...);
+
+t_float sys_getsr(void);
+int sys_getblksize(void);
+
+#endif /* __m_pd_h_ */
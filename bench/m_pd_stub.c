@@ -0,0 +1,327 @@
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* stub implementation of the parts of the Pd API that [hidio] uses, so the  */
+/* core can be benchmarked outside of Pd.  Allocations and outlet messages   */
+/* are counted so hidio_bench.c can report them per event.                   */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "m_pd.h"
+#include "m_pd_stub.h"
+
+unsigned long stub_allocations = 0;
+unsigned long stub_frees = 0;
+unsigned long stub_outlet_messages = 0;
+unsigned long stub_outlet_atoms = 0;
+double stub_logical_time = 0;
+int stub_quiet = 1;
+
+t_symbol s_ = {"", 0, 0};
+t_symbol s_float = {"float", 0, 0};
+t_symbol s_list = {"list", 0, 0};
+t_symbol s_bang = {"bang", 0, 0};
+t_symbol s_symbol = {"symbol", 0, 0};
+
+struct _outlet
+{
+    t_object *o_owner;
+    t_symbol *o_sym;
+};
+
+struct _clock
+{
+    void *c_owner;
+    t_method c_fn;
+    double c_settime;
+};
+
+struct _class
+{
+    t_symbol *c_name;
+    size_t c_size;
+};
+
+/*------------------------------------------------------------------------------
+ * symbols
+ */
+
+#define SYMTABHASHSIZE 1024
+
+static t_symbol *symhash[SYMTABHASHSIZE];
+
+t_symbol *gensym(const char *s)
+{
+    unsigned int hash = 5381;
+    const char *c;
+    t_symbol *sym;
+    char *name;
+
+    for(c = s; *c; ++c)
+        hash = ((hash << 5) + hash) + (unsigned char)*c;
+    for(sym = symhash[hash % SYMTABHASHSIZE]; sym; sym = sym->s_next)
+        if(strcmp(sym->s_name, s) == 0)
+            return sym;
+    sym = (t_symbol *)malloc(sizeof(t_symbol));
+    name = (char *)malloc(strlen(s) + 1);
+    strcpy(name, s);
+    sym->s_name = name;
+    sym->s_thing = 0;
+    sym->s_next = symhash[hash % SYMTABHASHSIZE];
+    symhash[hash % SYMTABHASHSIZE] = sym;
+    stub_allocations += 2;
+    return sym;
+}
+
+/*------------------------------------------------------------------------------
+ * memory
+ */
+
+void *getbytes(size_t nbytes)
+{
+    ++stub_allocations;
+    return calloc(1, nbytes ? nbytes : 1);
+}
+
+void *resizebytes(void *old, size_t oldsize, size_t newsize)
+{
+    void *ret = realloc(old, newsize ? newsize : 1);
+    ++stub_allocations;
+    if(ret && newsize > oldsize)
+        memset((char *)ret + oldsize, 0, newsize - oldsize);
+    return ret;
+}
+
+void freebytes(void *x, size_t nbytes)
+{
+    ++stub_frees;
+    free(x);
+}
+
+/*------------------------------------------------------------------------------
+ * printing
+ */
+
+void post(const char *fmt, ...)
+{
+    va_list ap;
+    if(stub_quiet) return;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+}
+
+void error(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+}
+
+void pd_error(const void *object, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+}
+
+/*------------------------------------------------------------------------------
+ * atoms
+ */
+
+t_float atom_getfloat(const t_atom *a)
+{
+    return (a->a_type == A_FLOAT) ? a->a_w.w_float : 0;
+}
+
+t_int atom_getint(const t_atom *a)
+{
+    return (t_int)atom_getfloat(a);
+}
+
+t_symbol *atom_getsymbol(const t_atom *a)
+{
+    return (a->a_type == A_SYMBOL) ? a->a_w.w_symbol : &s_;
+}
+
+t_float atom_getfloatarg(int which, int argc, const t_atom *argv)
+{
+    return (which < argc) ? atom_getfloat(argv + which) : 0;
+}
+
+t_int atom_getintarg(int which, int argc, const t_atom *argv)
+{
+    return (t_int)atom_getfloatarg(which, argc, argv);
+}
+
+t_symbol *atom_getsymbolarg(int which, int argc, const t_atom *argv)
+{
+    return (which < argc) ? atom_getsymbol(argv + which) : &s_;
+}
+
+void atom_string(const t_atom *a, char *buf, unsigned int bufsize)
+{
+    if(a->a_type == A_SYMBOL)
+        snprintf(buf, bufsize, "%s", a->a_w.w_symbol->s_name);
+    else if(a->a_type == A_FLOAT)
+        snprintf(buf, bufsize, "%g", a->a_w.w_float);
+    else if(bufsize)
+        *buf = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * outlets
+ */
+
+t_outlet *outlet_new(t_object *owner, t_symbol *s)
+{
+    t_outlet *x = (t_outlet *)getbytes(sizeof(t_outlet));
+    x->o_owner = owner;
+    x->o_sym = s;
+    return x;
+}
+
+void outlet_bang(t_outlet *x)
+{
+    ++stub_outlet_messages;
+}
+
+void outlet_float(t_outlet *x, t_float f)
+{
+    ++stub_outlet_messages;
+    ++stub_outlet_atoms;
+}
+
+void outlet_symbol(t_outlet *x, t_symbol *s)
+{
+    ++stub_outlet_messages;
+    ++stub_outlet_atoms;
+}
+
+void outlet_list(t_outlet *x, t_symbol *s, int argc, t_atom *argv)
+{
+    ++stub_outlet_messages;
+    stub_outlet_atoms += argc;
+}
+
+void outlet_anything(t_outlet *x, t_symbol *s, int argc, t_atom *argv)
+{
+    ++stub_outlet_messages;
+    stub_outlet_atoms += argc;
+}
+
+void outlet_free(t_outlet *x)
+{
+    freebytes(x, sizeof(t_outlet));
+}
+
+/*------------------------------------------------------------------------------
+ * clocks, the bench advances logical time itself
+ */
+
+t_clock *clock_new(void *owner, t_method fn)
+{
+    t_clock *x = (t_clock *)getbytes(sizeof(t_clock));
+    x->c_owner = owner;
+    x->c_fn = fn;
+    x->c_settime = -1;
+    return x;
+}
+
+void clock_set(t_clock *x, double systime)
+{
+    x->c_settime = systime;
+}
+
+void clock_delay(t_clock *x, double delaytime)
+{
+    x->c_settime = stub_logical_time + delaytime;
+}
+
+void clock_unset(t_clock *x)
+{
+    x->c_settime = -1;
+}
+
+void clock_free(t_clock *x)
+{
+    freebytes(x, sizeof(t_clock));
+}
+
+double clock_getlogicaltime(void)
+{
+    return stub_logical_time;
+}
+
+double clock_gettimesince(double prevsystime)
+{
+    return stub_logical_time - prevsystime;
+}
+
+/*------------------------------------------------------------------------------
+ * classes
+ */
+
+t_class *class_new(t_symbol *name, t_newmethod newmethod, t_method freemethod,
+                   size_t size, int flags, t_atomtype arg1, ...)
+{
+    t_class *c = (t_class *)getbytes(sizeof(t_class));
+    c->c_name = name;
+    c->c_size = size;
+    return c;
+}
+
+void class_addmethod(t_class *c, t_method fn, t_symbol *sel,
+                     t_atomtype arg1, ...)
+{
+}
+
+void class_addbang(t_class *c, t_method fn)
+{
+}
+
+void class_addfloat(t_class *c, t_method fn)
+{
+}
+
+void class_addanything(t_class *c, t_method fn)
+{
+}
+
+t_pd *pd_new(t_class *cls)
+{
+    t_pd *x = (t_pd *)getbytes(cls->c_size);
+    *x = cls;
+    return x;
+}
+
+void pd_float(t_pd *x, t_float f)
+{
+    ++stub_outlet_messages;
+    ++stub_outlet_atoms;
+}
+
+void dsp_add(t_perfroutine f, int n, ...)
+{
+}
+
+t_float sys_getsr(void)
+{
+    return 44100;
+}
+
+int sys_getblksize(void)
+{
+    return 64;
+}
@@ -0,0 +1,16 @@
+#ifndef _M_PD_STUB_H
+#define _M_PD_STUB_H
+
+/* counters kept by m_pd_stub.c */
+extern unsigned long stub_allocations;
+extern unsigned long stub_frees;
+extern unsigned long stub_outlet_messages;
+extern unsigned long stub_outlet_atoms;
+
+/* the bench drives logical time, clock_getlogicaltime() returns this */
+extern double stub_logical_time;
+
+/* when non-zero, post() is silenced */
+extern int stub_quiet;
+
+#endif  /* NOT _M_PD_STUB_H */
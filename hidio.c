@@ -32,9 +32,21 @@
 #else
 #include <unistd.h>
 #include <ctype.h>
+#include <time.h>
 #endif /* _WIN32 */
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#endif /* __APPLE__ */
+#include <errno.h>
 #include <stdarg.h>
 #include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif /* SIMD */
 
 #include "hidio.h"
 
@@ -45,39 +57,30 @@
 #define DEBUG(x)
 //#define DEBUG(x) x 
 
-unsigned short global_debug_level = 0; /* high numbers means more messages */
 
 /*------------------------------------------------------------------------------
  *  GLOBAL VARIABLES
  */
 
-/* count the number of instances of this object so that certain free()
- * functions can be called only after the final instance is detroyed.
- */
-t_int hidio_instance_count;
-
-/* this is used to test for the first instance to execute */
-double last_execute_time[MAX_DEVICES];
-
 static t_class *hidio_class;
 
-/* mostly for status querying */
-unsigned short device_count;
-
-/* store element structs to eliminate symbol table lookups, etc. */
-t_hid_element *element[MAX_DEVICES][MAX_ELEMENTS];
-/* number of active elements per device */
-unsigned short element_count[MAX_DEVICES]; 
+/* the element tables, counters and symbols, see t_hidio_context */
+#ifdef PDINSTANCE
+static t_class *hidio_context_class;
+PERTHREAD t_pdinstance *hidio_context_owner;
+PERTHREAD t_hidio_context *hidio_context_current;
+#else
+t_hidio_context hidio_context;
+#endif /* PDINSTANCE */
 
 /* pre-generated symbols */
-t_symbol *ps_open, *ps_device, *ps_poll, *ps_total, *ps_range;
-t_symbol *ps_absolute, *ps_button, *ps_key, *ps_led, *ps_pid, *ps_relative;
-t_symbol *absolute_symbols[ABSOLUTE_ARRAY_MAX];
-t_symbol *button_symbols[BUTTON_ARRAY_MAX];
-t_symbol *key_symbols[KEY_ARRAY_MAX];
-t_symbol *led_symbols[LED_ARRAY_MAX];
-t_symbol *pid_symbols[PID_ARRAY_MAX];
-t_symbol *relative_symbols[RELATIVE_ARRAY_MAX];
+#define ps_open (hidio_this->c_ps_open)
+#define ps_device (hidio_this->c_ps_device)
+#define ps_poll (hidio_this->c_ps_poll)
+#define ps_total (hidio_this->c_ps_total)
+#define ps_range (hidio_this->c_ps_range)
+#define ps_stats (hidio_this->c_ps_stats)
+#define ps_snapshot (hidio_this->c_ps_snapshot)
 
 /* TODO consider issuing a pd_error if more than one instance is attached to
  * one given device */
@@ -96,9 +99,64 @@ static void hidio_open(t_hidio *x, t_symbol *s, int argc, t_atom *argv);
  * SUPPORT FUNCTIONS
  */
 
+/* fill in the symbols of the current context, the rest starts out as 0 */
+static void hidio_init_context(void)
+{
+    /* pre-generate often used symbols */
+    ps_open = gensym("open");
+    ps_device = gensym("device");
+    ps_poll = gensym("poll");
+    ps_total = gensym("total");
+    ps_range = gensym("range");
+    ps_stats = gensym("stats");
+    ps_snapshot = gensym("snapshot");
+
+    generate_type_symbols();
+}
+
+#ifdef PDINSTANCE
+/* the slow path of hidio_this: look up the context of the current Pd
+ * instance in its own symbol table, or make one if this is the first time */
+t_hidio_context *hidio_find_context(void)
+{
+    t_symbol *context_symbol = gensym("#hidio_context");
+    t_hidio_context *context = (t_hidio_context *)context_symbol->s_thing;
+
+    if(context == NULL)
+    {
+        context = (t_hidio_context *)pd_new(hidio_context_class);
+        pd_bind(&context->c_pd, context_symbol);
+    }
+    hidio_context_owner = pd_this;
+    hidio_context_current = context;
+    if(context->c_ps_open == NULL) /* new, the symbols go thru hidio_this */
+        hidio_init_context();
+    return context;
+}
+
+/* called when the last [hidio] of a Pd instance goes away.  The cache of
+ * hidio_this is cleared too, a Pd instance made later can get the same
+ * address as this one and would otherwise find the freed context */
+static void hidio_free_context(void)
+{
+    t_hidio_context *context = hidio_this;
+    unsigned short i, j;
+
+    for(i = 0; i < HIDIO_SLOTS; ++i)
+    {
+        for(j = 0; j < context->c_element_count[i]; ++j)
+            freebytes(context->c_element[i][j], sizeof(t_hid_element));
+    }
+    pd_unbind(&context->c_pd, gensym("#hidio_context"));
+    pd_free(&context->c_pd);
+    hidio_context_owner = NULL;
+    hidio_context_current = NULL;
+}
+#endif /* PDINSTANCE */
+
 void debug_post(t_int message_debug_level, const char *fmt, ...)
 {
-    if(message_debug_level <= global_debug_level)
+    if(message_debug_level <= hidio_debug_level)
     {
         char buf[MAXPDSTRING];
         va_list ap;
@@ -113,7 +171,7 @@ void debug_post(t_int message_debug_level, const char *fmt, ...)
 
 void debug_error(t_hidio *x, t_int message_debug_level, const char *fmt, ...)
 {
-    if(message_debug_level <= global_debug_level)
+    if(message_debug_level <= hidio_debug_level)
     {
         char buf[MAXPDSTRING];
         va_list ap;
@@ -145,7 +203,10 @@ static void output_open_status(t_hidio *x)
 
 static void output_device_number(t_hidio *x)
 {
-    output_status(x, ps_device, x->x_device_number);
+    if(x->x_shm_name)
+        output_status(x, ps_device, x->x_shm_device_number);
+    else
+        output_status(x, ps_device, x->x_device_number);
 }
 
 static void output_poll_time(t_hidio *x)
@@ -155,7 +216,7 @@ static void output_poll_time(t_hidio *x)
 
 static void output_device_count(t_hidio *x)
 {
-    output_status(x, ps_total, device_count);
+    output_status(x, ps_total, hidio_device_count);
 }
 
 static void output_element_ranges(t_hidio *x)
@@ -165,18 +226,18 @@ static void output_element_ranges(t_hidio *x)
         unsigned int i;
         t_atom output_data[4];
         
-        for(i=0;i<element_count[x->x_device_number];++i)
+        for(i=0;i<hidio_element_count[x->x_device_number];++i)
         {
 #ifdef PD
-            SETSYMBOL(output_data, element[x->x_device_number][i]->type);
-            SETSYMBOL(output_data + 1, element[x->x_device_number][i]->name);
-            SETFLOAT(output_data + 2, element[x->x_device_number][i]->min);
-            SETFLOAT(output_data + 3, element[x->x_device_number][i]->max);
+            SETSYMBOL(output_data, hidio_element_table[x->x_device_number][i]->type);
+            SETSYMBOL(output_data + 1, hidio_element_table[x->x_device_number][i]->name);
+            SETFLOAT(output_data + 2, hidio_element_table[x->x_device_number][i]->min);
+            SETFLOAT(output_data + 3, hidio_element_table[x->x_device_number][i]->max);
 #else
-            atom_setsym(output_data, element[x->x_device_number][i]->type);
-            atom_setsym(output_data + 1, element[x->x_device_number][i]->name);
-            atom_setlong(output_data + 2, element[x->x_device_number][i]->min);
-            atom_setlong(output_data + 3, element[x->x_device_number][i]->max);
+            atom_setsym(output_data, hidio_element_table[x->x_device_number][i]->type);
+            atom_setsym(output_data + 1, hidio_element_table[x->x_device_number][i]->name);
+            atom_setlong(output_data + 2, hidio_element_table[x->x_device_number][i]->min);
+            atom_setlong(output_data + 3, hidio_element_table[x->x_device_number][i]->max);
 #endif /* PD */
             outlet_anything(x->x_status_outlet, ps_range, 4, output_data);
         }
@@ -184,6 +245,63 @@ static void output_element_ranges(t_hidio *x)
 }
 
 
+static const char *overflow_names[] = {"defer", "coalesce", "drop"};
+
+static void output_stats(t_hidio *x)
+{
+    t_hidio_stats *stats;
+    t_atom output_data[LATENCY_BUCKETS + 1];
+    unsigned int i;
+
+    if(x->x_device_number < 0)
+        return;
+    stats = hidio_stats + x->x_device_number;
+    SETSYMBOL(output_data, gensym("read"));
+    SETFLOAT(output_data + 1, stats->events_read);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("emitted"));
+    SETFLOAT(output_data + 1, stats->events_emitted);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("coalesced"));
+    SETFLOAT(output_data + 1, stats->events_coalesced);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("filtered"));
+    SETFLOAT(output_data + 1, stats->events_filtered);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("syscalls"));
+    SETFLOAT(output_data + 1, stats->read_calls);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("resyncs"));
+    SETFLOAT(output_data + 1, stats->resyncs);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("interval"));
+    SETFLOAT(output_data + 1, stats->report_interval);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("budget"));
+    SETFLOAT(output_data + 1, x->x_budget);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("overflow"));
+    SETSYMBOL(output_data + 1, gensym(overflow_names[x->x_overflow]));
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("overflows"));
+    SETFLOAT(output_data + 1, stats->overflows);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("dropped"));
+    SETFLOAT(output_data + 1, stats->events_dropped);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("idle"));
+    SETFLOAT(output_data + 1, stats->empty_ticks);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("maxburst"));
+    SETFLOAT(output_data + 1, stats->max_events_per_tick);
+    outlet_anything(x->x_status_outlet, ps_stats, 2, output_data);
+    SETSYMBOL(output_data, gensym("latency"));
+    for(i = 0; i < LATENCY_BUCKETS; ++i)
+        SETFLOAT(output_data + 1 + i, stats->latency[i]);
+    outlet_anything(x->x_status_outlet, ps_stats, LATENCY_BUCKETS + 1, output_data);
+}
+
+
 static unsigned int name_to_usage(char *usage_name)
 { // output usagepage << 16 + usage
     if(strcmp(usage_name,"pointer") == 0)   return 0x00010001;
@@ -206,10 +324,11 @@ static t_int convert_symbol_hex_to_int(t_symbol *s)
 }
 
 
-static short get_device_number_from_arguments(int argc, t_atom *argv)
+/* everything that needs Pd or Max is done here on the main thread, see
+ * hidio_resolve_open_args() for the part that probes the devices */
+static void hidio_parse_open_args(int argc, t_atom *argv, t_hidio_open_args *args)
 {
 #ifdef PD
-    short device_number = -1;
     char device_type_string[MAXPDSTRING] = "";
     unsigned short device_type_instance;
 #else
@@ -217,12 +336,11 @@ static short get_device_number_from_arguments(int argc, t_atom *argv)
     char *device_type_string;
     long device_type_instance;
 #endif /* PD */
-    unsigned int usage;
-    unsigned short vendor_id;
-    unsigned short product_id;
     t_symbol *first_argument;
     t_symbol *second_argument;
 
+    memset(args, 0, sizeof(t_hidio_open_args));
+    args->device_number = -1;
     if(argc == 1)
     {
 #ifdef PD
@@ -234,12 +352,13 @@ static short get_device_number_from_arguments(int argc, t_atom *argv)
 #endif /* PD */
         { // single float arg means device #
 #ifdef PD
-            device_number = (short) atom_getfloatarg(0,argc,argv);
+            args->device_number = (short) atom_getfloatarg(0,argc,argv);
 #else
             atom_arg_getlong(&device_number, 0, argc, argv);
+            args->device_number = (short) device_number;
 #endif /* PD */
-            if(device_number < 0) device_number = -1;
-            debug_post(LOG_DEBUG,"[hidio] setting device# to %d",device_number);
+            if(args->device_number < 0) args->device_number = -1;
+            debug_post(LOG_DEBUG,"[hidio] setting device# to %d",args->device_number);
         }
         else
         { // single symbol arg means first instance of a device type
@@ -249,11 +368,9 @@ static short get_device_number_from_arguments(int argc, t_atom *argv)
             device_type_string = atom_string(argv);
             // LATER do we have to free this string manually???
 #endif /* PD */
-            usage = name_to_usage(device_type_string);
-            device_number = get_device_number_from_usage(0, usage >> 16, 
-                                                         usage & 0xffff);
+            args->usage = name_to_usage(device_type_string);
             debug_post(LOG_INFO,"[hidio] using 0x%04x 0x%04x for %s",
-                        usage >> 16, usage & 0xffff, device_type_string);
+                        args->usage >> 16, args->usage & 0xffff, device_type_string);
         }
     }
     else if(argc == 2)
@@ -270,31 +387,231 @@ static short get_device_number_from_arguments(int argc, t_atom *argv)
         { /* a symbol then a float means match on usage */
 #ifdef PD
             atom_string(argv, device_type_string, MAXPDSTRING-1);
-            usage = name_to_usage(device_type_string);
+            args->usage = name_to_usage(device_type_string);
             device_type_instance = atom_getfloatarg(1,argc,argv);
 #else
             device_type_string = atom_string(argv);
-            usage = name_to_usage(device_type_string);
+            args->usage = name_to_usage(device_type_string);
             atom_arg_getlong(&device_type_instance, 1, argc, argv);
 #endif /* PD */
+            args->instance = device_type_instance;
             debug_post(LOG_DEBUG,"[hidio] looking for %s at #%d",
                         device_type_string, device_type_instance);
-            device_number = get_device_number_from_usage(device_type_instance,
-                                                              usage >> 16, 
-                                                              usage & 0xffff);
         }
         else
         { /* two symbols means idVendor and idProduct in hex */
-            vendor_id = 
+            args->vendor_id = 
                 (unsigned short) strtol(first_argument->s_name, NULL, 16);
-            product_id = 
+            args->product_id = 
                 (unsigned short) strtol(second_argument->s_name, NULL, 16);
-            device_number = get_device_number_by_id(vendor_id,product_id);
         }
     }
-    return device_number;
 }
 
+/* this may probe all the devices, so no Pd or Max calls in here, it runs on
+ * the worker thread with [async 1( */
+short hidio_resolve_open_args(t_hidio_open_args *args)
+{
+    if(args->usage)
+        return get_device_number_from_usage(args->instance, args->usage >> 16,
+                                            args->usage & 0xffff);
+    if(args->vendor_id || args->product_id)
+        return get_device_number_by_id(args->vendor_id, args->product_id);
+    return args->device_number;
+}
+
+static short get_device_number_from_arguments(int argc, t_atom *argv)
+{
+    t_hidio_open_args args;
+
+    hidio_parse_open_args(argc, argv, &args);
+    return hidio_resolve_open_args(&args);
+}
+
+
+/* a monotonic clock in milliseconds, in the same timebase as the event
+ * timestamps the backends pass to hidio_element_update() */
+double hidio_get_system_time(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#elif defined(__APPLE__)
+    static double conversion = 0.0;
+    if(conversion == 0.0)
+    {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        conversion = 1e-6 * (double) info.numer / (double) info.denom;
+    }
+    return conversion * (double) mach_absolute_time();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec * 1e-6;
+#endif /* _WIN32 */
+}
+
+/* store a new value in the element, filtered by [subscribe(, [deadband( and
+ * [hysteresis(, hidio_tick() then outputs the ones that changed */
+static void hidio_store_value(short device_number, t_hid_element *updated_element,
+                              t_int value, double timestamp)
+{
+    t_hidio_stats *stats = hidio_stats + device_number;
+    t_int change, change_size;
+
+    int32_t *current_value = hidio_element_values[device_number] + updated_element->id;
+    int32_t previous_value = hidio_element_previous[device_number][updated_element->id];
+    unsigned char *pending = hidio_element_pending[device_number] + updated_element->id;
+
+    /* the OS might not support masking, or these were queued before it */
+    if(hidio_subscribed_count[device_number] && !updated_element->subscribed)
+        return;
+    if(!updated_element->relative && 
+       (updated_element->deadband || updated_element->hysteresis))
+    {
+        /* compare against what was output last, so that slow drift still
+         * gets thru once it adds up to more than the deadband */
+        change = value - previous_value;
+        change_size = (change < 0) ? -change : change;
+        if( (change_size <= updated_element->deadband) ||
+            ((change * updated_element->direction < 0) && 
+             (change_size <= updated_element->hysteresis)) )
+        {
+            ++stats->events_filtered;
+            *current_value = previous_value;
+            return;
+        }
+    }
+    if(*pending)
+        ++stats->events_coalesced;
+    if(updated_element->relative)
+        *current_value += value; /* summed up until the next tick */
+    else
+        *current_value = value;
+    updated_element->timestamp = timestamp;
+    *pending = 1;
+}
+
+/* backends call this for every event they get */
+void hidio_element_update(t_hidio *x, t_hid_element *updated_element,
+                          t_int value, double timestamp)
+{
+    t_hidio_stats *stats = hidio_stats + x->x_device_number;
+    t_hidio_queued_event *queued_event;
+    double report_interval;
+
+    ++stats->events_read;
+    ++stats->tick_events;
+    /* [publish( shares every event before any of the filtering */
+    if( x->x_shm && !x->x_shm_name && (x->x_multi_count == 0) )
+        hidio_shm_write(x->x_shm, updated_element->id, value, timestamp);
+    /* all events of a report share a timestamp, so a new one is a new report */
+    if( (timestamp > 0) && (timestamp != stats->last_report_time) )
+    {
+        report_interval = timestamp - stats->last_report_time;
+        /* longer gaps are the device sitting idle, not its report rate */
+        if( (stats->last_report_time > 0) && (report_interval > 0) &&
+            (report_interval < ADAPTIVE_MAX_DELAY) )
+        {
+            if(stats->report_interval > 0)
+                stats->report_interval += (report_interval - stats->report_interval) * 0.125;
+            else
+                stats->report_interval = report_interval;
+        }
+        stats->last_report_time = timestamp;
+    }
+    if(x->x_overflow == OVERFLOW_DROP)
+    {
+        /* hold it in the ring, hidio_flush_ring() stores what survives */
+        if(x->x_ring_count == x->x_budget)
+        {
+            x->x_ring_start = (x->x_ring_start + 1) % x->x_budget;
+            --x->x_ring_count;
+            ++stats->events_dropped;
+        }
+        queued_event = x->x_ring + (x->x_ring_start + x->x_ring_count) % x->x_budget;
+        queued_event->queued_element = updated_element;
+        queued_event->value = value;
+        queued_event->timestamp = timestamp;
+        ++x->x_ring_count;
+        return;
+    }
+    hidio_store_value(x->x_device_number, updated_element, value, timestamp);
+}
+
+static void hidio_flush_ring(t_hidio *x)
+{
+    t_hidio_queued_event *queued_event;
+
+    while(x->x_ring_count > 0)
+    {
+        queued_event = x->x_ring + x->x_ring_start;
+        hidio_store_value(x->x_device_number, queued_event->queued_element,
+                          queued_event->value, queued_event->timestamp);
+        x->x_ring_start = (x->x_ring_start + 1) % x->x_budget;
+        --x->x_ring_count;
+    }
+    x->x_ring_start = 0;
+}
+
+/* backends check this before getting each event or report from the OS, with
+ * OVERFLOW_DEFER the rest stays queued once the budget is used up */
+int hidio_events_wanted(t_hidio *x)
+{
+    return (x->x_overflow != OVERFLOW_DEFER) || 
+        (hidio_stats[x->x_device_number].tick_events < (unsigned long)x->x_budget);
+}
+
+static double hidio_time_since(double logical_time)
+{
+#ifdef PD
+    return clock_gettimesince(logical_time);
+#else /* Max */
+    double right_now;
+    clock_getftime(&right_now);
+    return right_now - logical_time;
+#endif /* PD */
+}
+
+static void hidio_count_latency(t_hidio_stats *stats, double now, double timestamp)
+{
+    double bucket_limit = 0.5;
+    unsigned int i;
+
+    for(i = 0; i < LATENCY_BUCKETS - 1; ++i, bucket_limit *= 2)
+    {
+        if(now - timestamp < bucket_limit)
+            break;
+    }
+    ++stats->latency[i];
+}
+
+/* the value of the element as it is output, scaled if [normalize( is on */
+static void hidio_set_value_atom(t_atom *value_atom, t_hid_element *output_element)
+{
+    int32_t value = ELEMENT_VALUE(output_element);
+#ifdef PD
+    if(output_element->scale != 0)
+        SETFLOAT(value_atom, value * output_element->scale + output_element->offset);
+    else
+        SETFLOAT(value_atom, value);
+#else /* Max */
+    if(output_element->scale != 0)
+        atom_setfloat(value_atom, value * output_element->scale + output_element->offset);
+    else
+        atom_setlong(value_atom, (long)value);
+#endif /* PD */
+}
+
+t_float hidio_output_value(t_hid_element *output_element)
+{
+    if(output_element->scale != 0)
+        return ELEMENT_VALUE(output_element) * output_element->scale + output_element->offset;
+    return ELEMENT_VALUE(output_element);
+}
 
 /* output_message[3] is pre-generated by hidio_build_element_list() and
  * stored in t_hid_element, then just the value is updated.  This saves a bit
@@ -303,12 +620,8 @@ void hidio_output_event(t_hidio *x, t_hid_element *output_element)
 {
 /*        debug_post(LOG_DEBUG,"hidio_output_event: instance %d/%d last: %llu", 
                    x->x_instance+1, hidio_instance_count,
-                   last_execute_time[x->x_device_number]);*/
-#ifdef PD
-        SETFLOAT(output_element->output_message + 2, output_element->value);
-#else /* Max */
-        atom_setlong(output_element->output_message + 2, (long)output_element->value);
-#endif /* PD */
+                   hidio_last_execute_time[x->x_device_number]);*/
+        hidio_set_value_atom(output_element->output_message + 2, output_element);
         outlet_anything(x->x_data_outlet, output_element->type, 3, 
                         output_element->output_message);
 }
@@ -328,6 +641,11 @@ void hidio_write_event(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
         pd_error(x, "[hidio] write message must have exactly 4 atoms");
         return;
     }
+    if(x->x_shm_name)
+    {
+        pd_error(x, "[hidio] write: only the publisher can write to the device");
+        return;
+    }
 
     first_argument = atom_getsymbolarg(0,argc,argv);
     if(first_argument == &s_) 
@@ -360,196 +678,1605 @@ void hidio_write_event(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
     }
 }
 
-/* stop polling the device */
-static void hidio_stop_poll(t_hidio* x) 
+/* backends call this before making the elements of a device, then store
+ * the initial values in hidio_element_values and hidio_element_previous */
+void hidio_clear_element_values(short device_number)
 {
-  debug_post(LOG_DEBUG,"hidio_stop_poll");
-  
-  if (x->x_started) 
-  { 
-      clock_unset(x->x_clock);
-      debug_post(LOG_INFO,"[hidio] polling stopped");
-      x->x_started = 0;
-  }
+    memset(hidio_element_values[device_number], 0, sizeof(hidio_element_values[device_number]));
+    memset(hidio_element_previous[device_number], 0, sizeof(hidio_element_previous[device_number]));
+    memset(hidio_element_relative[device_number], 0, sizeof(hidio_element_relative[device_number]));
+    memset(hidio_element_pending[device_number], 0, sizeof(hidio_element_pending[device_number]));
 }
 
-/*------------------------------------------------------------------------------
- * METHODS FOR [hidio]'s MESSAGES                    
- */
+/* symbols are unique, so their addresses can be hashed directly */
+static unsigned int element_index_hash(t_symbol *type, t_symbol *name, t_int instance)
+{
+    unsigned long hash = ((unsigned long)type >> 3) * 31 + ((unsigned long)name >> 3);
+    hash = hash * 31 + (unsigned long)instance;
+    return (unsigned int)(hash ^ (hash >> 16)) & (ELEMENT_INDEX_SIZE - 1);
+}
 
-/* TODO: poll time should be set based on how fast the OS is actually polling
- * the device, whether that is IOUSBEndpointDescriptor.bInterval, or something
- * else.
- */
-void hidio_poll(t_hidio* x, t_float f) 
+/* Elements that share a type and name are numbered 0, 1, 2... in the order
+ * of the devices and their element lists, so that e.g. the two sticks of a
+ * gamepad are [absolute x 0( and [absolute x 1(.  The hash is keyed by
+ * type and name only and holds the last element seen of each, so this is a
+ * single pass.  Several devices are numbered as one for [open-composite( */
+static void hidio_number_instances(short *device_numbers, t_int number_of_devices)
 {
-    debug_post(LOG_DEBUG,"hidio_poll");
-  
-/*    if the user sets the delay less than 2, set to block size */
-    if( f > 2 )
-        x->x_delay = (t_int)f;
-    else if( f > 0 ) //TODO make this the actual time between message processing
-        x->x_delay = 1.54; 
-    if(x->x_device_number > -1) 
+    t_hid_element *last_seen[ELEMENT_INDEX_SIZE];
+    t_hid_element *current_element;
+    unsigned int i, slot, used = 0;
+    t_int k;
+
+    memset(last_seen, 0, sizeof(last_seen));
+    for(k = 0; k < number_of_devices; ++k)
     {
-        if(!x->x_device_open)
+        for(i = 0; i < hidio_element_count[device_numbers[k]]; ++i)
         {
-            hidio_open(x,ps_open,0,NULL);
+            current_element = hidio_element_table[device_numbers[k]][i];
+            current_element->instance = 0;
+            slot = element_index_hash(current_element->type, current_element->name, 0);
+            while(last_seen[slot] && 
+                  ( (last_seen[slot]->type != current_element->type) ||
+                    (last_seen[slot]->name != current_element->name) ) )
+                slot = (slot + 1) & (ELEMENT_INDEX_SIZE - 1);
+            if(last_seen[slot])
+                current_element->instance = last_seen[slot]->instance + 1;
+            else if(used < ELEMENT_INDEX_SIZE - 1)
+                ++used;
+            else
+                slot = ELEMENT_INDEX_SIZE; /* full, the rest stay instance 0 */
+            if(slot < ELEMENT_INDEX_SIZE)
+                last_seen[slot] = current_element;
+#ifdef PD
+            SETFLOAT(current_element->output_message + 1, current_element->instance);
+#else
+            atom_setlong(current_element->output_message + 1, (long)current_element->instance);
+#endif /* PD */
         }
-        if(!x->x_started) 
-        {
-            clock_delay(x->x_clock, x->x_delay);
-            debug_post(LOG_DEBUG,"[hidio] polling started");
-            x->x_started = 1;
-        } 
     }
 }
 
-static void hidio_set_from_float(t_hidio *x, t_floatarg f)
+static void hidio_build_element_index(short device_number)
 {
-/* values greater than 1 set the polling delay time */
-/* 1 and 0 for start/stop so you can use a [tgl] */
-    if(f > 1)
-    {
-        x->x_delay = (t_int)f;
-        hidio_poll(x,f);
-    }
-    else if(f == 1) 
-    {
-        if(! x->x_started)
-        {
-            hidio_poll(x,f);
-        }
-    }
-    else if(f == 0)         
+    t_hid_element *current_element;
+    unsigned int i, slot;
+
+    memset(hidio_element_index[device_number], 0, sizeof(hidio_element_index[device_number]));
+    for(i=0; i<hidio_element_count[device_number]; ++i)
     {
-        hidio_stop_poll(x);
+        current_element = hidio_element_table[device_number][i];
+        current_element->device_number = device_number;
+        current_element->id = i;
+        hidio_element_relative[device_number][i] = current_element->relative ? -1 : 0;
+        hidio_element_pending[device_number][i] = 0;
+        slot = element_index_hash(current_element->type, current_element->name,
+                                  (t_int)current_element->instance);
+        while(hidio_element_index[device_number][slot])
+            slot = (slot + 1) & (ELEMENT_INDEX_SIZE - 1);
+        hidio_element_index[device_number][slot] = i + 1;
     }
 }
 
-/* close the device */
-static void hidio_close(t_hidio *x) 
+t_hid_element *hidio_find_element(short device_number, t_symbol *type,
+                                  t_symbol *name, t_int instance)
 {
-    debug_post(LOG_DEBUG,"hidio_close");
-
- /* just to be safe, stop it first */
-     hidio_stop_poll(x);
+    t_hid_element *current_element;
+    unsigned int slot;
 
-     if(hidio_close_device(x) != 0)
-         debug_error(x, LOG_ERR,"[hidio] error closing device %d",x->x_device_number);
-     debug_post(LOG_DEBUG,"[hidio] closed device %d",x->x_device_number);
-     x->x_device_open = 0;
-     output_open_status(x);
+    if(device_number < 0)
+        return NULL;
+    slot = element_index_hash(type, name, instance);
+    while(hidio_element_index[device_number][slot])
+    {
+        current_element = hidio_element_table[device_number][hidio_element_index[device_number][slot] - 1];
+        if( (current_element->type == type) && (current_element->name == name)
+            && ((t_int)current_element->instance == instance) )
+            return current_element;
+        slot = (slot + 1) & (ELEMENT_INDEX_SIZE - 1);
+    }
+    return NULL;
 }
 
-
-/* hidio_open behavoir
- * current state                 action
- * ---------------------------------------
- * closed / same device          open 
- * open / same device            no action 
- * closed / different device     open 
- * open / different device       close, open 
- */
-static void hidio_open(t_hidio *x, t_symbol *s, int argc, t_atom *argv) 
+/* [get absolute y 0( outputs the last value of that element just like an
+ * event, without reading anything from the device */
+static void hidio_get(t_hidio *x, t_symbol *type, t_symbol *name, t_floatarg instance)
 {
-    short new_device_number = get_device_number_from_arguments(argc, argv);
-    t_int started = x->x_started; // store state to restore after device is opened
-    debug_post(LOG_DEBUG,"hid_%s",s->s_name);
-    
-    if (new_device_number > -1)
+    t_hid_element *current_element;
+    t_int k;
+
+    if( (x->x_device_number < 0) || (!x->x_device_open) )
     {
-        /* check whether we have to close previous device */
-        if (x->x_device_open && new_device_number != x->x_device_number)
-        {
-            hidio_close(x);
-        }
-        /* no device open, so open one now */
-        if (!x->x_device_open)
-        {
-            if(hidio_open_device(x, new_device_number) == EXIT_SUCCESS)
-            {
-                x->x_device_open = 1;
-                x->x_device_number = new_device_number;
-                /* restore the polling state so that when I [tgl] is used to
-                 * start/stop [hidio], the [tgl]'s state will continue to
-                 * accurately reflect [hidio]'s state  */
-                if (started)
-                    hidio_set_from_float(x,x->x_delay); // TODO is this useful?
-                debug_post(LOG_DEBUG,"[hidio] set device# to %d",new_device_number);
-                output_device_number(x);
-            }
-            else
-            {
-                x->x_device_number = -1;
-                pd_error(x, "[hidio] can not open device %d",new_device_number);
-            }
-        }
+        pd_error(x, "[hidio] get: no device open");
+        return;
     }
-    else 
-        debug_error(x, LOG_WARNING,"[hidio] device does not exist");
-    /* always output open result so you can test for success in Pd space */
-    output_open_status(x);
+    current_element = hidio_find_element(x->x_device_number, type, name, (t_int)instance);
+    /* the elements of a composite device are spread over its nodes */
+    for(k = 0; (current_element == NULL) && x->x_composite && (k < x->x_multi_count); ++k)
+        current_element = hidio_find_element(x->x_multi_devices[k], type, name, 
+                                             (t_int)instance);
+    if(current_element == NULL)
+        pd_error(x, "[hidio] get: no element %s %s %d", 
+                 type->s_name, name->s_name, (int)instance);
+    else
+        hidio_output_event(x, current_element);
 }
 
+static void hidio_set_element_filter(t_hid_element *current_element, 
+                                     t_symbol *filter, t_float amount)
+{
+    if(amount < 0) amount = 0;
+    if(filter == gensym("deadband"))
+        current_element->deadband = (t_int)amount;
+    else if(filter == gensym("hysteresis"))
+        current_element->hysteresis = (t_int)amount;
+    else /* ratelimit */
+        current_element->min_interval = amount;
+}
 
-static void hidio_tick(t_hidio *x)
+/* [deadband 3( sets all absolute elements of the open device,
+ * [deadband absolute x 3( or [deadband absolute x 1 3( just one of them.
+ * [hysteresis( and [ratelimit( (in ms) work the same way */
+static void hidio_filter(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
 {
-    debug_post(LOG_DEBUG,"hidio_tick");
     t_hid_element *current_element;
+    t_symbol *type, *name;
+    t_int instance = 0;
     unsigned int i;
-    double right_now;
-
-#ifdef PD
-    right_now = clock_getlogicaltime();
-#else /* Max */
-    clock_getftime(&right_now);
-#endif /* PD */
 
-//    debug_post(LOG_DEBUG,"# %u\tnow: %llu\tlast: %llu", x->x_device_number,
-//                right_now, last_execute_time[x->x_device_number]);
-    if(right_now > last_execute_time[x->x_device_number])
+    if( (x->x_device_number < 0) || (!x->x_device_open) )
     {
-        hidio_get_events(x);
-        last_execute_time[x->x_device_number] = right_now;
-/*        debug_post(LOG_DEBUG,"executing: instance %d/%d at %llu last: %llu", 
-             x->x_instance+1, hidio_instance_count, right_now,
-             last_execute_time[x->x_device_number]);*/
+        pd_error(x, "[hidio] %s: no device open", s->s_name);
+        return;
     }
-    for(i=0; i< element_count[x->x_device_number]; ++i)
+    if(argc == 1)
     {
-        /* TODO: since relative events need to be output every time, they need
-         * to be flagged when new relative events arrive.  Otherwise, it'll
-         * just spam out relative events no matter if anything new has
-         * arrived */
-        current_element = element[x->x_device_number][i];
-        debug_post(LOG_DEBUG,"element[%d][%d] value %d previous %d usage page 0x%02X usage_id %d",
-    		x->x_device_number, i, current_element->value,
-			current_element->previous_value, current_element->usage_page, current_element->usage_id);
-        if(current_element->previous_value != current_element->value)
+        for(i=0; i<hidio_element_count[x->x_device_number]; ++i)
         {
-            hidio_output_event(x, current_element);
+            current_element = hidio_element_table[x->x_device_number][i];
             if(!current_element->relative)
-                current_element->previous_value = current_element->value;
+                hidio_set_element_filter(current_element, s, 
+                                         atom_getfloatarg(0,argc,argv));
         }
     }
-    if (x->x_started) 
+    else if( (argc == 3) || (argc == 4) )
     {
-        clock_delay(x->x_clock, x->x_delay);
+        type = atom_getsymbolarg(0,argc,argv);
+        name = atom_getsymbolarg(1,argc,argv);
+        if(argc == 4)
+            instance = atom_getintarg(2,argc,argv);
+        current_element = hidio_find_element(x->x_device_number, type, name, instance);
+        if(current_element == NULL)
+            pd_error(x, "[hidio] %s: no element %s %s %d", s->s_name, 
+                     type->s_name, name->s_name, (int)instance);
+        else
+            hidio_set_element_filter(current_element, s, 
+                                     atom_getfloatarg(argc-1,argc,argv));
     }
+    else
+        pd_error(x, "[hidio] usage: %s [type name [instance]] amount", s->s_name);
 }
 
-static void hidio_info(t_hidio *x)
+/* output the current value of every element with state as one message:
+ * [snapshot type name instance value type name instance value ...( on the
+ * data outlet.  Relative elements only have deltas, so they are left out.
+ * This only looks at the element table, it does not read any events. */
+static void hidio_snapshot(t_hidio *x)
 {
-    output_open_status(x);
-    output_device_number(x);
-    output_device_count(x);
-    output_poll_time(x);
-    output_element_ranges(x);
-    hidio_platform_specific_info(x);
-}
+    t_hid_element *current_element;
+    t_atom *output_data;
+    unsigned int i, count = 0;
 
-static void hidio_float(t_hidio* x, t_floatarg f) 
+    if( (x->x_device_number < 0) || (!x->x_device_open) )
+    {
+        pd_error(x, "[hidio] snapshot: no device open");
+        return;
+    }
+    output_data = (t_atom *)getbytes(hidio_element_count[x->x_device_number] * 4 * sizeof(t_atom));
+    for(i=0; i<hidio_element_count[x->x_device_number]; ++i)
+    {
+        current_element = hidio_element_table[x->x_device_number][i];
+        if(current_element->relative)
+            continue;
+        SETSYMBOL(output_data + count, current_element->type);
+        output_data[count + 1] = current_element->output_message[0];
+        output_data[count + 2] = current_element->output_message[1];
+        hidio_set_value_atom(output_data + count + 3, current_element);
+        count += 4;
+    }
+    outlet_anything(x->x_data_outlet, ps_snapshot, count, output_data);
+    freebytes(output_data, hidio_element_count[x->x_device_number] * 4 * sizeof(t_atom));
+}
+
+/* [subscribe absolute x [instance]( only lets the subscribed elements thru,
+ * on GNU/Linux the kernel then drops all other events before they are
+ * queued.  [unsubscribe absolute x( removes one, [unsubscribe( all of them,
+ * which lets all events thru again */
+static void hidio_subscribe(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    t_hid_element *current_element;
+    t_symbol *type, *name;
+    t_int instance = 0;
+    unsigned char subscribe = (s == gensym("subscribe"));
+    unsigned int i;
+
+    if( (x->x_device_number < 0) || (!x->x_device_open) )
+    {
+        pd_error(x, "[hidio] %s: no device open", s->s_name);
+        return;
+    }
+    if( (argc == 0) && !subscribe )
+    {
+        for(i=0; i<hidio_element_count[x->x_device_number]; ++i)
+            hidio_element_table[x->x_device_number][i]->subscribed = 0;
+        hidio_subscribed_count[x->x_device_number] = 0;
+    }
+    else if( (argc == 2) || (argc == 3) )
+    {
+        type = atom_getsymbolarg(0,argc,argv);
+        name = atom_getsymbolarg(1,argc,argv);
+        instance = atom_getintarg(2,argc,argv);
+        current_element = hidio_find_element(x->x_device_number, type, name, instance);
+        if(current_element == NULL)
+        {
+            pd_error(x, "[hidio] %s: no element %s %s %d", s->s_name, 
+                     type->s_name, name->s_name, (int)instance);
+            return;
+        }
+        if(current_element->subscribed == subscribe)
+            return;
+        current_element->subscribed = subscribe;
+        if(subscribe)
+            ++hidio_subscribed_count[x->x_device_number];
+        else
+            --hidio_subscribed_count[x->x_device_number];
+    }
+    else
+    {
+        pd_error(x, "[hidio] usage: %s type name [instance]", s->s_name);
+        return;
+    }
+    hidio_set_event_mask(x);
+}
+
+/* map min..max of the element to low..high, or back to raw values if the
+ * range is empty.  Relative elements have no meaningful range so they are
+ * always output raw */
+static void hidio_set_element_range(t_hid_element *current_element, 
+                                    t_float low, t_float high)
+{
+    if( (low == high) || current_element->relative || 
+        (current_element->max == current_element->min) )
+    {
+        current_element->scale = 0;
+        current_element->offset = 0;
+    }
+    else
+    {
+        current_element->scale = (high - low) / 
+            (t_float)(current_element->max - current_element->min);
+        current_element->offset = low - current_element->min * current_element->scale;
+    }
+}
+
+static void hidio_set_device_range(short device_number, t_float low, t_float high)
+{
+    unsigned int i;
+
+    if(device_number < 0)
+        return;
+    for(i=0; i<hidio_element_count[device_number]; ++i)
+        hidio_set_element_range(hidio_element_table[device_number][i], low, high);
+}
+
+/* parse 'off', 'unit' (0 to 1), 'bipolar' (-1 to 1) or 'range low high',
+ * returns 0 on success.  'off' is stored as the empty range 0 0 */
+static int hidio_parse_normalize_mode(int argc, t_atom *argv, 
+                                      t_float *low, t_float *high)
+{
+    t_symbol *mode = atom_getsymbolarg(0,argc,argv);
+
+    if( (mode == gensym("off")) && (argc == 1) )
+        *low = *high = 0;
+    else if( (mode == gensym("unit")) && (argc == 1) )
+    {
+        *low = 0;
+        *high = 1;
+    }
+    else if( (mode == gensym("bipolar")) && (argc == 1) )
+    {
+        *low = -1;
+        *high = 1;
+    }
+    else if( (mode == gensym("range")) && (argc == 3) )
+    {
+        *low = atom_getfloatarg(1,argc,argv);
+        *high = atom_getfloatarg(2,argc,argv);
+    }
+    else
+        return -1;
+    return 0;
+}
+
+/* [normalize unit( sets the mode for all elements of every device this
+ * instance opens, [normalize absolute x [instance] unit( for one element of
+ * the open device.  Elements are shared by all instances using a device, so
+ * the last setting wins */
+static void hidio_normalize(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    t_hid_element *current_element;
+    t_symbol *type, *name;
+    t_int instance = 0;
+    t_float low, high;
+    int mode_start = 2;
+
+    if(argc < 1)
+        goto usage;
+    if(hidio_parse_normalize_mode(argc, argv, &low, &high) == 0)
+    {
+        x->x_normalize = (low != high);
+        x->x_normalize_low = low;
+        x->x_normalize_high = high;
+        if(x->x_device_open)
+            hidio_set_device_range(x->x_device_number, low, high);
+        return;
+    }
+    if(argc < 3)
+        goto usage;
+    type = atom_getsymbolarg(0,argc,argv);
+    name = atom_getsymbolarg(1,argc,argv);
+    if(argv[2].a_type == A_FLOAT)
+    {
+        instance = atom_getintarg(2,argc,argv);
+        mode_start = 3;
+    }
+    if(hidio_parse_normalize_mode(argc - mode_start, argv + mode_start, 
+                                  &low, &high) != 0)
+        goto usage;
+    if( (x->x_device_number < 0) || (!x->x_device_open) )
+    {
+        pd_error(x, "[hidio] normalize: no device open");
+        return;
+    }
+    current_element = hidio_find_element(x->x_device_number, type, name, instance);
+    if(current_element == NULL)
+        pd_error(x, "[hidio] normalize: no element %s %s %d", 
+                 type->s_name, name->s_name, (int)instance);
+    else
+        hidio_set_element_range(current_element, low, high);
+    return;
+usage:
+    pd_error(x, "[hidio] usage: normalize [type name [instance]] off|unit|bipolar|range low high");
+}
+
+/* stop polling the device */
+static void hidio_stop_poll(t_hidio* x) 
+{
+  debug_post(LOG_DEBUG,"hidio_stop_poll");
+  
+  if (x->x_started) 
+  { 
+      clock_unset(x->x_clock);
+      debug_post(LOG_INFO,"[hidio] polling stopped");
+      x->x_started = 0;
+  }
+}
+
+/*------------------------------------------------------------------------------
+ * METHODS FOR [hidio]'s MESSAGES                    
+ */
+
+static void hidio_schedule_tick(t_hidio *x)
+{
+    t_float delay = (x->x_adaptive_max > 0) ? x->x_adaptive_delay : x->x_delay;
+#ifdef PD
+    clock_delay(x->x_clock, delay);
+#else /* Max */
+    clock_fdelay(x->x_clock, delay);
+#endif /* PD */
+}
+
+/* [adaptive 1( polls at the rate the device is sending reports while there
+ * is data, and doubles the delay on each empty poll up to 250ms, or the
+ * limit given as the second argument.  [adaptive 0( goes back to [poll( */
+static void hidio_adaptive(t_hidio *x, t_floatarg f, t_floatarg max_delay)
+{
+    if(f == 0)
+        x->x_adaptive_max = 0;
+    else
+    {
+        x->x_adaptive_max = (max_delay > 0) ? max_delay : ADAPTIVE_MAX_DELAY;
+        x->x_adaptive_delay = x->x_delay;
+    }
+}
+
+static void hidio_adapt_delay(t_hidio *x, t_hidio_stats *stats)
+{
+    if(stats->tick_events > 0)
+    {
+        x->x_adaptive_delay = (stats->report_interval > 0) ? 
+            stats->report_interval : x->x_delay;
+        if(x->x_adaptive_delay < ADAPTIVE_MIN_DELAY)
+            x->x_adaptive_delay = ADAPTIVE_MIN_DELAY;
+    }
+    else
+        x->x_adaptive_delay *= 2;
+    if(x->x_adaptive_delay > x->x_adaptive_max)
+        x->x_adaptive_delay = x->x_adaptive_max;
+}
+
+/* TODO: poll time should be set based on how fast the OS is actually polling
+ * the device, whether that is IOUSBEndpointDescriptor.bInterval, or something
+ * else.
+ */
+void hidio_poll(t_hidio* x, t_float f) 
+{
+    debug_post(LOG_DEBUG,"hidio_poll");
+  
+/*    any delay is kept as it is, [dspsync 1( polls once per DSP block */
+    if( f > 0 )
+        x->x_delay = f;
+    if(x->x_device_number > -1) 
+    {
+        if(!x->x_device_open)
+        {
+            hidio_open(x,ps_open,0,NULL);
+        }
+        if(!x->x_started) 
+        {
+            hidio_schedule_tick(x);
+            debug_post(LOG_DEBUG,"[hidio] polling started");
+            x->x_started = 1;
+        } 
+    }
+}
+
+static void hidio_set_from_float(t_hidio *x, t_floatarg f)
+{
+/* values greater than 1 set the polling delay time */
+/* 1 and 0 for start/stop so you can use a [tgl] */
+    if(f > 1)
+    {
+        hidio_poll(x,f);
+    }
+    else if(f == 1) 
+    {
+        if(! x->x_started)
+        {
+            hidio_poll(x,0);
+        }
+    }
+    else if(f == 0)         
+    {
+        hidio_stop_poll(x);
+    }
+}
+
+#ifdef PD
+/* [dspsync 1( polls once per DSP block from the DSP tick, like [bang~], so
+ * the reads line up with the audio blocks.  Nothing is polled while DSP is
+ * off.  [dspsync 0( goes back to polling with the clock. */
+static void hidio_dspsync(t_hidio *x, t_floatarg f)
+{
+    x->x_dsp_sync = (f != 0);
+    if(x->x_dsp_sync)
+    {
+        clock_unset(x->x_clock);
+        if(!x->x_started)
+            hidio_poll(x, 0);
+    }
+    else if(x->x_started)
+        hidio_schedule_tick(x);
+}
+
+static t_int *hidio_perform(t_int *w)
+{
+    t_hidio *x = (t_hidio *)(w[1]);
+    if(x->x_dsp_sync && x->x_started)
+        clock_delay(x->x_clock, 0);
+    return (w+2);
+}
+
+static void hidio_dsp(t_hidio *x, t_signal **sp)
+{
+    dsp_add(hidio_perform, 1, x);
+}
+#endif /* PD */
+
+static t_symbol *hidio_atom_symbol(t_atom *a)
+{
+#ifdef PD
+    return atom_getsymbol(a);
+#else /* Max */
+    return atom_getsym(a);
+#endif /* PD */
+}
+
+static int hidio_atom_is_number(t_atom *a)
+{
+#ifdef PD
+    return a->a_type == A_FLOAT;
+#else /* Max */
+    return (a->a_type == A_FLOAT) || (a->a_type == A_LONG);
+#endif /* PD */
+}
+
+/* takes the '-out type name [instance]' flags out of the creation arguments
+ * and stores them in x_routes, and '-shm name' into x_shm_name.  The other
+ * arguments are copied to device_argv for get_device_number_from_arguments() */
+static int hidio_parse_routes(t_hidio *x, int argc, t_atom *argv, t_atom *device_argv)
+{
+    t_hidio_route *route;
+    t_symbol *ps_out = gensym("-out");
+    t_symbol *ps_shm = gensym("-shm");
+    int i, j, device_argc = 0;
+
+    x->x_shm_name = NULL;
+    x->x_shm_device_number = -1;
+    x->x_route_count = 0;
+    x->x_route_size = 0;
+    for(i = 0; i < argc; ++i)
+        if(hidio_atom_symbol(argv + i) == ps_out)
+            ++x->x_route_size;
+    x->x_routes = NULL;
+    x->x_element_routes = NULL;
+    if(x->x_route_size > 0)
+        x->x_routes = (t_hidio_route *)getbytes(x->x_route_size * sizeof(t_hidio_route));
+    route = x->x_routes;
+    for(i = 0; i < argc; )
+    {
+        if( (hidio_atom_symbol(argv + i) == ps_shm) && (i + 1 < argc) )
+        {
+            x->x_shm_name = hidio_atom_symbol(argv + i + 1);
+            i += 2;
+            continue;
+        }
+        if(hidio_atom_symbol(argv + i) != ps_out)
+        {
+            device_argv[device_argc++] = argv[i++];
+            continue;
+        }
+        if(i + 2 >= argc)
+        {
+            /* nothing else can follow a trailing one */
+            pd_error(x, "[hidio] -out needs a type and a name");
+            i = argc;
+            continue;
+        }
+        if( hidio_atom_is_number(argv + i + 1) || hidio_atom_is_number(argv + i + 2) ||
+            (hidio_atom_symbol(argv + i + 1) == ps_out) ||
+            (hidio_atom_symbol(argv + i + 1) == ps_shm) ||
+            (hidio_atom_symbol(argv + i + 2) == ps_out) ||
+            (hidio_atom_symbol(argv + i + 2) == ps_shm) )
+        {
+            /* skip the flag and what was meant for it, up to the next flag,
+             * the rest are still device arguments or flags */
+            pd_error(x, "[hidio] -out needs a type and a name");
+            for(++i, j = 0; (j < 2) && (hidio_atom_symbol(argv + i) != ps_out) &&
+                    (hidio_atom_symbol(argv + i) != ps_shm); ++i, ++j)
+                ;
+            continue;
+        }
+        route->type = hidio_atom_symbol(argv + i + 1);
+        route->name = hidio_atom_symbol(argv + i + 2);
+        route->instance = 0;
+        route->outlet = NULL;
+        route->receiver = NULL;
+        i += 3;
+        if( (i < argc) && hidio_atom_is_number(argv + i) )
+        {
+#ifdef PD
+            route->instance = (t_int)atom_getfloat(argv + i);
+#else /* Max */
+            route->instance = (t_int)atom_getlong(argv + i);
+#endif /* PD */
+            ++i;
+        }
+        ++route;
+        ++x->x_route_count;
+    }
+    x->x_outlet_count = x->x_route_count;
+    return device_argc;
+}
+
+/* point each element of the open device that was given with -out or [bind(
+ * to its route, so hidio_tick() can output it without outlet_anything().
+ * Later routes for the same element win, so [bind( overrides -out */
+static void hidio_resolve_routes(t_hidio *x)
+{
+    t_hid_element *current_element;
+    t_hidio_route *route;
+    unsigned int i;
+    t_int j;
+
+    if( (x->x_route_count == 0) || (!x->x_device_open) )
+        return;
+    if(x->x_element_routes == NULL)
+        x->x_element_routes = (t_hidio_route **)getbytes(MAX_ELEMENTS * sizeof(t_hidio_route *));
+    memset(x->x_element_routes, 0, MAX_ELEMENTS * sizeof(t_hidio_route *));
+    for(j = 0; j < x->x_route_count; ++j)
+    {
+        route = x->x_routes + j;
+        for(i = 0; i < hidio_element_count[x->x_device_number]; ++i)
+        {
+            current_element = hidio_element_table[x->x_device_number][i];
+            if( (current_element->type == route->type) && 
+                (current_element->name == route->name) &&
+                ((t_int)current_element->instance == route->instance) )
+            {
+                x->x_element_routes[i] = route;
+                break;
+            }
+        }
+        if(i == hidio_element_count[x->x_device_number])
+            debug_error(x, LOG_WARNING, "[hidio] %s %s %d: no such element",
+                        route->type->s_name, route->name->s_name, (int)route->instance);
+    }
+}
+
+#ifdef PD
+/* [bind absolute x joy-x( sends the values of that element straight to
+ * [r joy-x] instead of out the outlet, the instance is optional like with
+ * [get(.  [unbind absolute x( undoes it, [unbind( removes all bindings. */
+static void hidio_bind(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    t_hidio_route *route;
+    t_symbol *type, *name, *receiver;
+    t_int instance = 0;
+    t_int j;
+
+    if( (argc != 3) && (argc != 4) )
+    {
+        pd_error(x, "[hidio] usage: bind type name [instance] receiver");
+        return;
+    }
+    type = atom_getsymbolarg(0,argc,argv);
+    name = atom_getsymbolarg(1,argc,argv);
+    if(argc == 4)
+        instance = atom_getintarg(2,argc,argv);
+    receiver = atom_getsymbolarg(argc-1,argc,argv);
+    for(j = x->x_outlet_count; j < x->x_route_count; ++j)
+    {
+        route = x->x_routes + j;
+        if( (route->type == type) && (route->name == name) && 
+            (route->instance == instance) )
+            break;
+    }
+    if(j == x->x_route_count)
+    {
+        if(x->x_route_count == x->x_route_size)
+        {
+            x->x_routes = (t_hidio_route *)resizebytes(x->x_routes, 
+                x->x_route_size * sizeof(t_hidio_route), 
+                (x->x_route_size + 1) * sizeof(t_hidio_route));
+            ++x->x_route_size;
+        }
+        ++x->x_route_count;
+    }
+    route = x->x_routes + j;
+    route->type = type;
+    route->name = name;
+    route->instance = instance;
+    route->outlet = NULL;
+    route->receiver = receiver;
+    hidio_resolve_routes(x);
+}
+
+static void hidio_unbind(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    t_hidio_route *route;
+    t_symbol *type = atom_getsymbolarg(0,argc,argv);
+    t_symbol *name = atom_getsymbolarg(1,argc,argv);
+    t_int instance = atom_getintarg(2,argc,argv);
+    t_int j, new_count = x->x_outlet_count;
+
+    for(j = x->x_outlet_count; j < x->x_route_count; ++j)
+    {
+        route = x->x_routes + j;
+        if( (argc > 0) && ((route->type != type) || (route->name != name) ||
+                           (route->instance != instance)) )
+            x->x_routes[new_count++] = *route;
+    }
+    if(new_count == x->x_route_count)
+        return;
+    /* the space stays allocated for the next [bind( */
+    x->x_route_count = new_count;
+    if(x->x_element_routes)
+        memset(x->x_element_routes, 0, MAX_ELEMENTS * sizeof(t_hidio_route *));
+    hidio_resolve_routes(x);
+}
+#endif /* PD */
+
+/* the device slot of a [hidio -shm name], one of the HIDIO_SHM_SLOTS after
+ * the real devices, so that it never writes into the tables of a device
+ * opened here.  -1 if they are all taken */
+static short hidio_get_shm_slot(t_hidio *x)
+{
+    short i, free_slot = -1;
+
+    for(i = 0; i < HIDIO_SHM_SLOTS; ++i)
+    {
+        if(hidio_this->c_shm_readers[i] == x)
+            return MAX_DEVICES + i;
+        if( (hidio_this->c_shm_readers[i] == NULL) && (free_slot < 0) )
+            free_slot = i;
+    }
+    if(free_slot < 0)
+        return -1;
+    hidio_this->c_shm_readers[free_slot] = x;
+    return MAX_DEVICES + free_slot;
+}
+
+static void hidio_free_shm_elements(short slot)
+{
+    unsigned short i;
+
+    for(i = 0; i < hidio_element_count[slot]; ++i)
+        freebytes(hidio_element_table[slot][i], sizeof(t_hid_element));
+    hidio_element_count[slot] = 0;
+}
+
+/* give the slot of a [hidio -shm name] back, with its elements */
+static void hidio_release_shm_slot(t_hidio *x)
+{
+    short i;
+
+    for(i = 0; i < HIDIO_SHM_SLOTS; ++i)
+    {
+        if(hidio_this->c_shm_readers[i] == x)
+        {
+            hidio_free_shm_elements(MAX_DEVICES + i);
+            hidio_this->c_shm_readers[i] = NULL;
+        }
+    }
+}
+
+/* put the element table of the open device into the shared memory of
+ * [publish(, an empty one when there is none */
+static void hidio_publish_elements(t_hidio *x)
+{
+    t_hid_element *current_element;
+    short device_number = x->x_device_number;
+    unsigned int i, count = 0;
+
+    if( (x->x_shm == NULL) || x->x_shm_name )
+        return;
+    hidio_shm_begin_elements(x->x_shm);
+    if( x->x_device_open && (device_number > -1) && (x->x_multi_count == 0) )
+    {
+        count = hidio_element_count[device_number];
+        for(i = 0; i < count; ++i)
+        {
+            current_element = hidio_element_table[device_number][i];
+            hidio_shm_set_element(x->x_shm, i, current_element->type->s_name,
+                                  current_element->name->s_name,
+                                  (int)current_element->instance,
+                                  current_element->min, current_element->max,
+                                  current_element->relative, ELEMENT_VALUE(current_element));
+        }
+    }
+    else
+        device_number = -1;
+    hidio_shm_end_elements(x->x_shm, device_number, count);
+}
+
+/* [publish name( puts every event of the device opened with [open( into
+ * shared memory, for [hidio -shm name] in other Pd instances and for other
+ * programs using hidio_shm.h.  [publish( without a name stops */
+static void hidio_publish(t_hidio *x, t_symbol *name)
+{
+    if(x->x_shm_name)
+    {
+        pd_error(x, "[hidio] publish: this one reads from shared memory");
+        return;
+    }
+    hidio_shm_close(x->x_shm);
+    x->x_shm = NULL;
+    if( (name == NULL) || (name->s_name[0] == '\0') )
+        return;
+    x->x_shm = hidio_shm_publish(name->s_name);
+    if(x->x_shm == NULL)
+    {
+        /* EBUSY when another [hidio] or program already publishes it */
+        pd_error(x, "[hidio] publish %s: %s", name->s_name, strerror(errno));
+        return;
+    }
+    hidio_publish_elements(x);
+}
+
+/* close the device */
+static void hidio_close(t_hidio *x) 
+{
+    debug_post(LOG_DEBUG,"hidio_close");
+
+ /* just to be safe, stop it first */
+     hidio_stop_poll(x);
+
+     if(x->x_shm_name)
+     {
+         hidio_shm_close(x->x_shm);
+         x->x_shm = NULL;
+         hidio_release_shm_slot(x);
+     }
+     else if(x->x_multi_count > 0)
+     {
+         hidio_close_multi(x);
+         x->x_multi_count = 0;
+     }
+     else if(hidio_close_device(x) != 0)
+         debug_error(x, LOG_ERR,"[hidio] error closing device %d",x->x_device_number);
+     debug_post(LOG_DEBUG,"[hidio] closed device %d",x->x_device_number);
+     x->x_device_open = 0;
+     hidio_publish_elements(x);
+     output_open_status(x);
+}
+
+
+/* set up a freshly opened device, from hidio_open() or hidio_async_tick() */
+static void hidio_device_opened(t_hidio *x, short new_device_number, t_int started)
+{
+    x->x_device_open = 1;
+    x->x_device_number = new_device_number;
+    memset(hidio_stats + new_device_number, 0, sizeof(t_hidio_stats));
+    hidio_subscribed_count[new_device_number] = 0;
+    if(x->x_shm_name == NULL) /* -shm elements come numbered by the publisher */
+        hidio_number_instances(&new_device_number, 1);
+    hidio_build_element_index(new_device_number);
+    hidio_resolve_routes(x);
+    if(x->x_normalize)
+        hidio_set_device_range(new_device_number, x->x_normalize_low,
+                               x->x_normalize_high);
+    /* restore the polling state so that when I [tgl] is used to
+     * start/stop [hidio], the [tgl]'s state will continue to
+     * accurately reflect [hidio]'s state  */
+    if (started)
+        hidio_poll(x,0);
+    hidio_publish_elements(x);
+    debug_post(LOG_DEBUG,"[hidio] set device# to %d",new_device_number);
+    output_device_number(x);
+}
+
+/* [hidio -shm name] makes the elements from the table of the publisher in
+ * its own slot, and then acts as if it had opened the publisher's device */
+static void hidio_load_shm_elements(t_hidio *x)
+{
+    t_hidio_shm_element *shm_elements;
+    t_hid_element *new_element;
+    int32_t *values;
+    int i, count, device_number;
+    short slot;
+
+    shm_elements = (t_hidio_shm_element *)getbytes(MAX_ELEMENTS * sizeof(t_hidio_shm_element));
+    values = (int32_t *)getbytes(MAX_ELEMENTS * sizeof(int32_t));
+    count = hidio_shm_get_elements(x->x_shm, shm_elements, values, MAX_ELEMENTS,
+                                   &device_number);
+    if(count < 0)
+        ; /* the publisher is busy with it, try again on the next tick */
+    else if( (count == 0) || (device_number < 0) || (device_number >= MAX_DEVICES) )
+    {
+        hidio_release_shm_slot(x);
+        if(x->x_device_open)
+        {
+            x->x_device_open = 0;
+            x->x_device_number = -1;
+            output_open_status(x);
+        }
+    }
+    else if( (slot = hidio_get_shm_slot(x)) < 0 )
+        pd_error(x, "[hidio] -shm %s: more than %d readers", x->x_shm_name->s_name,
+                 HIDIO_SHM_SLOTS);
+    else
+    {
+        hidio_free_shm_elements(slot);
+        hidio_clear_element_values(slot);
+        x->x_shm_device_number = device_number;
+        for(i = 0; i < count; ++i)
+        {
+            new_element = getbytes(sizeof(t_hid_element));
+            new_element->type = gensym(shm_elements[i].type);
+            new_element->name = gensym(shm_elements[i].name);
+            new_element->instance = shm_elements[i].instance;
+            new_element->min = shm_elements[i].min;
+            new_element->max = shm_elements[i].max;
+            new_element->relative = shm_elements[i].relative;
+            /* the last event of a relative element is a delta, not a state */
+            if(!new_element->relative)
+                hidio_element_values[slot][i] = hidio_element_previous[slot][i] = values[i];
+            SETSYMBOL(new_element->output_message, new_element->name);
+#ifdef PD
+            SETFLOAT(new_element->output_message + 1, new_element->instance);
+#else /* Max */
+            atom_setlong(new_element->output_message + 1, (long)new_element->instance);
+#endif /* PD */
+            hidio_element_table[slot][i] = new_element;
+        }
+        hidio_element_count[slot] = count;
+        hidio_device_opened(x, slot, x->x_started);
+        output_open_status(x);
+    }
+    freebytes(values, MAX_ELEMENTS * sizeof(int32_t));
+    freebytes(shm_elements, MAX_ELEMENTS * sizeof(t_hidio_shm_element));
+}
+
+/* map the shared memory of -shm, then the elements are there */
+static void hidio_open_shm(t_hidio *x)
+{
+    if(x->x_shm == NULL)
+        x->x_shm = hidio_shm_attach(x->x_shm_name->s_name);
+    if(x->x_shm == NULL)
+    {
+        debug_error(x, LOG_WARNING, "[hidio] nothing published as %s: %s", 
+                    x->x_shm_name->s_name, strerror(errno));
+        output_open_status(x);
+        return;
+    }
+    hidio_load_shm_elements(x);
+}
+
+/* before each tick of [hidio -shm name], follow the publisher when it opens
+ * another device or goes away */
+static void hidio_check_shm(t_hidio *x)
+{
+    if(x->x_shm == NULL)
+        return;
+    if(hidio_shm_closed(x->x_shm))
+    {
+        hidio_shm_close(x->x_shm);
+        x->x_shm = NULL;
+        hidio_release_shm_slot(x);
+        x->x_device_open = 0;
+        x->x_device_number = -1;
+        output_open_status(x);
+    }
+    else if(hidio_shm_elements_changed(x->x_shm))
+        hidio_load_shm_elements(x);
+}
+
+/* what hidio_get_events() does for a device, from the shared memory */
+static void hidio_get_shm_events(t_hidio *x)
+{
+    t_hidio_shm_event shm_events[MAX_EVENTS_PER_POLL];
+    t_hidio_stats *stats = hidio_stats + x->x_device_number;
+    short device_number = x->x_device_number;
+    unsigned long lost;
+    int i, count, max_events;
+
+    if( (x->x_shm == NULL) || (device_number < 0) )
+        return;
+    lost = x->x_shm->lost;
+    while(hidio_events_wanted(x))
+    {
+        /* with [overflow defer(, the rest waits in the ring */
+        max_events = MAX_EVENTS_PER_POLL;
+        if( (x->x_overflow == OVERFLOW_DEFER) && 
+            (x->x_budget - (t_int)stats->tick_events < max_events) )
+            max_events = x->x_budget - (t_int)stats->tick_events;
+        count = hidio_shm_read(x->x_shm, shm_events, max_events);
+        for(i = 0; i < count; ++i)
+        {
+            if(shm_events[i].id < hidio_element_count[device_number])
+                hidio_element_update(x, hidio_element_table[device_number][shm_events[i].id],
+                                     shm_events[i].value, shm_events[i].timestamp);
+        }
+        if(count < max_events)
+            break;
+    }
+    stats->events_dropped += x->x_shm->lost - lost;
+}
+
+/* an [open( of any kind has to wait until the worker of [async 1( is done,
+ * hidio_async_tick() would otherwise open its device over the new one */
+static int hidio_async_busy(t_hidio *x, t_symbol *s)
+{
+    if(x->x_async_job == ASYNC_NONE)
+        return 0;
+    debug_error(x, LOG_ERR,"[hidio] %s: still busy with the last open or refresh",
+                s->s_name);
+    return 1;
+}
+
+/* hidio_open behavoir
+ * current state                 action
+ * ---------------------------------------
+ * closed / same device          open 
+ * open / same device            no action 
+ * closed / different device     open 
+ * open / different device       close, open 
+ */
+static void hidio_open(t_hidio *x, t_symbol *s, int argc, t_atom *argv) 
+{
+    short new_device_number;
+    t_int started = x->x_started; // store state to restore after device is opened
+    debug_post(LOG_DEBUG,"hid_%s",s->s_name);
+
+    if(x->x_shm_name)
+    {
+        /* the arguments are up to the publisher */
+        hidio_open_shm(x);
+        return;
+    }
+    if(hidio_async_busy(x, s))
+        return;
+    if(x->x_async)
+    {
+        /* the current device stays open until the new one is ready, then
+         * hidio_async_tick() finishes what is below */
+        hidio_parse_open_args(argc, argv, &x->x_async_args);
+        x->x_async_job = ASYNC_OPEN;
+        if(hidio_async_open(x) == EXIT_SUCCESS)
+        {
+            clock_delay(x->x_async_clock, ASYNC_POLL_DELAY);
+            return;
+        }
+        x->x_async_job = ASYNC_NONE;
+    }
+    new_device_number = get_device_number_from_arguments(argc, argv);
+    if (new_device_number > -1)
+    {
+        /* check whether we have to close previous device */
+        if (x->x_device_open && 
+            (new_device_number != x->x_device_number || x->x_multi_count > 0))
+        {
+            hidio_close(x);
+        }
+        /* no device open, so open one now */
+        if (!x->x_device_open)
+        {
+            if(hidio_open_device(x, new_device_number) == EXIT_SUCCESS)
+                hidio_device_opened(x, new_device_number, started);
+            else
+            {
+                x->x_device_number = -1;
+                pd_error(x, "[hidio] can not open device %d",new_device_number);
+            }
+        }
+    }
+    else 
+        debug_error(x, LOG_WARNING,"[hidio] device does not exist");
+    /* always output open result so you can test for success in Pd space */
+    output_open_status(x);
+}
+
+/* checks every ASYNC_POLL_DELAY ms whether the worker of [async 1( is done,
+ * then does the rest of hidio_open() or [refresh( on the main thread */
+static void hidio_async_tick(t_hidio *x)
+{
+    short new_device_number;
+    t_int started = x->x_started;
+
+    if(!hidio_async_done(x))
+    {
+        clock_delay(x->x_async_clock, ASYNC_POLL_DELAY);
+        return;
+    }
+    if(x->x_async_job == ASYNC_REFRESH)
+    {
+        hidio_async_finish(x);
+        x->x_async_job = ASYNC_NONE;
+        output_device_count(x);
+        return;
+    }
+    /* the worker stored the resolved device number */
+    new_device_number = x->x_async_args.device_number;
+    if(new_device_number < 0)
+    {
+        hidio_async_discard(x);
+        debug_error(x, LOG_WARNING,"[hidio] device does not exist");
+    }
+    else if(x->x_device_open && (new_device_number == x->x_device_number) && 
+            (x->x_multi_count == 0))
+        hidio_async_discard(x);
+    else
+    {
+        if(x->x_device_open)
+            hidio_close(x);
+        if(hidio_async_finish(x) == EXIT_SUCCESS)
+            hidio_device_opened(x, new_device_number, started);
+        else
+        {
+            x->x_device_number = -1;
+            pd_error(x, "[hidio] can not open device");
+        }
+    }
+    x->x_async_job = ASYNC_NONE;
+    output_open_status(x);
+}
+
+/* [refresh( */
+static void hidio_refresh(t_hidio *x)
+{
+    if(x->x_async_job != ASYNC_NONE)
+    {
+        pd_error(x, "[hidio] refresh: still busy with the last open or refresh");
+        return;
+    }
+    if(x->x_async)
+    {
+        x->x_async_job = ASYNC_REFRESH;
+        if(hidio_async_refresh(x) == EXIT_SUCCESS)
+        {
+            clock_delay(x->x_async_clock, ASYNC_POLL_DELAY);
+            return;
+        }
+        x->x_async_job = ASYNC_NONE;
+    }
+    hidio_build_device_list();
+}
+
+/* [async 1( opens devices and refreshes the device list on a worker thread,
+ * so that probing slow devices does not hold up audio.  The status outlet
+ * gets [open 1( and [device N( or [total N( once the worker is done */
+static void hidio_async(t_hidio *x, t_floatarg f)
+{
+    x->x_async = (f != 0);
+}
+
+/* [tablet 0( outputs the axes of a tablet one by one like any other device,
+ * instead of as [stylus( frames, GNU/Linux only */
+static void hidio_tablet(t_hidio *x, t_floatarg f)
+{
+    x->x_tablet = (f != 0);
+}
+
+
+/* opens the x_multi_count devices in x_multi_devices and sets them up like
+ * hidio_open() does for a single one */
+static void hidio_open_devices(t_hidio *x)
+{
+    short device_number;
+    t_int started = x->x_started;
+    t_int k;
+
+    if(x->x_multi_count == 0)
+        debug_error(x, LOG_WARNING,"[hidio] no devices to open");
+    else if(hidio_open_multi(x) > 0)
+    {
+        /* a composite device is one physical device split into several
+         * nodes by the OS, so its instances are numbered across all nodes */
+        if(x->x_composite)
+            hidio_number_instances(x->x_multi_devices, x->x_multi_count);
+        for(k = 0; k < x->x_multi_count; ++k)
+        {
+            device_number = x->x_multi_devices[k];
+            memset(hidio_stats + device_number, 0, sizeof(t_hidio_stats));
+            hidio_subscribed_count[device_number] = 0;
+            hidio_output_start[device_number] = 0;
+            if(!x->x_composite)
+                hidio_number_instances(&device_number, 1);
+            hidio_build_element_index(device_number);
+            if(x->x_normalize)
+                hidio_set_device_range(device_number, x->x_normalize_low,
+                                       x->x_normalize_high);
+            /* seeded values count as output, so only new events show up */
+            x->x_multi_active[k] = 0;
+        }
+        x->x_device_open = 1;
+        hidio_select_multi(x, 0);
+        if (started)
+            hidio_poll(x,0);
+        output_device_number(x);
+    }
+    else
+    {
+        x->x_multi_count = 0;
+        x->x_device_number = -1;
+        pd_error(x, "[hidio] can not open any of the devices");
+    }
+    output_open_status(x);
+}
+
+/* [open-all joystick( or [open-all 3 7 8( reads several devices with a single
+ * [hidio].  The events are then output as lists starting with the device
+ * number, so [route] can split them up again */
+static void hidio_open_all(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    char device_type_string[MAXPDSTRING] = "";
+    unsigned int usage;
+    short device_number;
+    t_int k;
+    debug_post(LOG_DEBUG,"hid_%s",s->s_name);
+
+    if(hidio_async_busy(x, s))
+        return;
+    if(x->x_device_open)
+        hidio_close(x);
+    x->x_composite = 0;
+    if( (argc == 1) && !hidio_atom_is_number(argv) )
+    {
+        snprintf(device_type_string, MAXPDSTRING, "%s", 
+                 hidio_atom_symbol(argv)->s_name);
+        usage = name_to_usage(device_type_string);
+        for(k = 0; k < MAX_MULTI_DEVICES; ++k)
+        {
+            device_number = get_device_number_from_usage(k, usage >> 16, 
+                                                         usage & 0xffff);
+            if(device_number < 0)
+                break;
+            x->x_multi_devices[x->x_multi_count++] = device_number;
+        }
+    }
+    else
+    {
+        for(k = 0; (k < argc) && (x->x_multi_count < MAX_MULTI_DEVICES); ++k)
+        {
+            device_number = (short) atom_getfloat(argv + k);
+            if( (device_number > -1) && (device_number < MAX_DEVICES) )
+                x->x_multi_devices[x->x_multi_count++] = device_number;
+        }
+    }
+    hidio_open_devices(x);
+}
+
+/* [open-composite( takes the same arguments as [open(, and also opens the
+ * other nodes of the same physical device, like the motion sensors and the
+ * touchpad of a gamepad.  They are output as one device */
+static void hidio_open_composite(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    short device_number;
+    debug_post(LOG_DEBUG,"hid_%s",s->s_name);
+
+    if(hidio_async_busy(x, s))
+        return;
+    device_number = get_device_number_from_arguments(argc, argv);
+    if(x->x_device_open)
+        hidio_close(x);
+    if(device_number > -1)
+    {
+        x->x_composite = 1;
+        x->x_multi_count = hidio_get_siblings(device_number, x->x_multi_devices);
+        hidio_open_devices(x);
+    }
+    else
+    {
+        debug_error(x, LOG_WARNING,"[hidio] device does not exist");
+        output_open_status(x);
+    }
+}
+
+
+/* get the events of the current device from the OS, returns 1 if there were
+ * more than the budget allows */
+static unsigned char hidio_read_events(t_hidio *x, t_hidio_stats *stats)
+{
+    stats->tick_events = 0;
+    if(x->x_shm_name)
+        hidio_get_shm_events(x);
+    else
+        hidio_get_events(x);
+    if(x->x_ring_count > 0)
+        hidio_flush_ring(x);
+    if(stats->tick_events == 0)
+        ++stats->empty_ticks;
+    else if(stats->tick_events > stats->max_events_per_tick)
+        stats->max_events_per_tick = stats->tick_events;
+    if(x->x_overflow == OVERFLOW_DEFER)
+        return stats->tick_events >= (unsigned long)x->x_budget;
+    return stats->tick_events > (unsigned long)x->x_budget;
+}
+
+/* in multi-device mode the output is a list starting with the device number */
+static void hidio_output_event_from(t_hidio *x, t_hid_element *output_element,
+                                    short device_number)
+{
+    t_atom output_data[5];
+
+#ifdef PD
+    SETFLOAT(output_data, device_number);
+#else /* Max */
+    atom_setlong(output_data, device_number);
+#endif /* PD */
+    SETSYMBOL(output_data + 1, output_element->type);
+    output_data[2] = output_element->output_message[0];
+    output_data[3] = output_element->output_message[1];
+    hidio_set_value_atom(output_data + 4, output_element);
+    outlet_list(x->x_data_outlet, &s_list, 5, output_data);
+}
+
+/* output one element, the way the mode and the -out routes ask for */
+static void hidio_output_element(t_hidio *x, t_hid_element *current_element,
+                                 short device_number, unsigned int i)
+{
+    t_hidio_route *route;
+
+    if(x->x_multi_count > 0 && !x->x_composite)
+        hidio_output_event_from(x, current_element, device_number);
+    else if(x->x_multi_count > 0)
+        hidio_output_event(x, current_element);
+    else
+    {
+        route = x->x_element_routes ? x->x_element_routes[i] : NULL;
+        if(route == NULL)
+            hidio_output_event(x, current_element);
+        else if(route->outlet)
+            outlet_float(route->outlet, hidio_output_value(current_element));
+#ifdef PD
+        else if(route->receiver->s_thing)
+            pd_float(route->receiver->s_thing, hidio_output_value(current_element));
+#endif /* PD */
+    }
+}
+
+/* the lowest set bit, for walking the changed-mask */
+static unsigned int hidio_lowest_bit(uint32_t word)
+{
+#ifdef __GNUC__
+    return __builtin_ctz(word);
+#else
+    unsigned int bit = 0;
+    while(!(word & 1))
+    {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif /* __GNUC__ */
+}
+
+/* set bit i of changed for each element that has something to output:
+ * a new value, or for relative elements any motion and then the 0 after it.
+ * This compares the value arrays 8 or 4 elements at a time where the
+ * compiler targets AVX2, SSE2 or NEON, so a full keyboard costs little more
+ * than a mouse when nothing happened */
+static void hidio_changed_mask(short device_number, unsigned int count, 
+                               uint32_t *changed)
+{
+    const int32_t *values = hidio_element_values[device_number];
+    const int32_t *previous = hidio_element_previous[device_number];
+    const int32_t *relative = hidio_element_relative[device_number];
+    unsigned int i = 0;
+
+    memset(changed, 0, ((count + 31) / 32) * sizeof(uint32_t));
+#if defined(__AVX2__)
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(values + i));
+        __m256i p = _mm256_loadu_si256((const __m256i *)(previous + i));
+        __m256i r = _mm256_loadu_si256((const __m256i *)(relative + i));
+        __m256i same = _mm256_cmpeq_epi32(v, p);
+        __m256i still = _mm256_cmpeq_epi32(_mm256_or_si256(v, p), _mm256_setzero_si256());
+        /* ~same | (r & ~still) */
+        __m256i diff = _mm256_or_si256(_mm256_xor_si256(same, _mm256_set1_epi32(-1)),
+                                       _mm256_andnot_si256(still, r));
+        changed[i / 32] |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(diff)) << (i % 32);
+    }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(values + i));
+        __m128i p = _mm_loadu_si128((const __m128i *)(previous + i));
+        __m128i r = _mm_loadu_si128((const __m128i *)(relative + i));
+        __m128i same = _mm_cmpeq_epi32(v, p);
+        __m128i still = _mm_cmpeq_epi32(_mm_or_si128(v, p), _mm_setzero_si128());
+        __m128i diff = _mm_or_si128(_mm_xor_si128(same, _mm_set1_epi32(-1)),
+                                    _mm_andnot_si128(still, r));
+        changed[i / 32] |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(diff)) << (i % 32);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    {
+        static const uint32_t bit_values[4] = {1, 2, 4, 8};
+        const uint32x4_t bits = vld1q_u32(bit_values);
+        for(; i + 4 <= count; i += 4)
+        {
+            int32x4_t v = vld1q_s32(values + i);
+            int32x4_t p = vld1q_s32(previous + i);
+            uint32x4_t r = vreinterpretq_u32_s32(vld1q_s32(relative + i));
+            uint32x4_t same = vceqq_s32(v, p);
+            uint32x4_t moving = vtstq_s32(vorrq_s32(v, p), vorrq_s32(v, p));
+            uint32x4_t diff = vorrq_u32(vmvnq_u32(same), vandq_u32(moving, r));
+            changed[i / 32] |= vaddvq_u32(vandq_u32(diff, bits)) << (i % 32);
+        }
+    }
+#endif /* SIMD */
+    for(; i < count; ++i)
+    {
+        if( (values[i] != previous[i]) || 
+            (relative[i] && ((values[i] != 0) || (previous[i] != 0))) )
+            changed[i / 32] |= 1u << (i % 32);
+    }
+}
+
+/* the first element from..to-1 that is set in changed, or to if none is */
+static unsigned int hidio_next_changed(const uint32_t *changed, unsigned int from,
+                                       unsigned int to)
+{
+    uint32_t word;
+
+    while(from < to)
+    {
+        word = changed[from / 32] >> (from % 32);
+        if(word)
+        {
+            from += hidio_lowest_bit(word);
+            return (from < to) ? from : to;
+        }
+        from = (from / 32 + 1) * 32;
+    }
+    return to;
+}
+
+/* output the elements of the current device that changed, at most x_budget
+ * of them, the ones that did not fit get their turn first on the next tick.
+ * Returns non-zero if something is left for the next tick. */
+static int hidio_output_changes(t_hidio *x, t_hidio_stats *stats, 
+                                double right_now, unsigned char *over_budget)
+{
+    t_hid_element *current_element;
+    short device_number = x->x_device_number;
+    int32_t *values = hidio_element_values[device_number];
+    int32_t *previous = hidio_element_previous[device_number];
+    unsigned char *pending = hidio_element_pending[device_number];
+    uint32_t changed[(MAX_ELEMENTS + 31) / 32];
+    unsigned int i, count, start, end, pass;
+    t_int emitted = 0;
+    int waiting = 0;
+    int stopped = 0;
+    int framed = 0;
+    double system_time = 0;
+
+    count = hidio_element_count[device_number];
+    if(hidio_output_start[device_number] >= count)
+        hidio_output_start[device_number] = 0;
+    start = hidio_output_start[device_number];
+    hidio_changed_mask(device_number, count, changed);
+    /* from hidio_output_start to the end, then from the beginning up to it */
+    for(pass = 0; (pass < 2) && !stopped; ++pass)
+    {
+        end = pass ? start : count;
+        for(i = hidio_next_changed(changed, pass ? 0 : start, end); i < end; 
+            i = hidio_next_changed(changed, i + 1, end))
+        {
+            current_element = hidio_element_table[device_number][i];
+#ifdef _WIN32
+            debug_post(LOG_DEBUG,"hidio_element_table[%d][%d] value %d previous %d usage page 0x%02X usage_id %d",
+                       device_number, i, values[i], previous[i], 
+                       current_element->usage_page, current_element->usage_id);
+#endif /* _WIN32 */
+            if(emitted == x->x_budget)
+            {
+                *over_budget = 1;
+                stopped = pass + 1;
+                break;
+            }
+            if(current_element->min_interval > 0)
+            {
+                /* too soon, leave it pending so the latest value is output
+                 * once the interval has passed */
+                if(hidio_time_since(current_element->last_output_time) < 
+                   current_element->min_interval)
+                {
+                    waiting = 1;
+                    continue;
+                }
+                current_element->last_output_time = right_now;
+            }
+            current_element->direction = (values[i] > previous[i]) ? 1 : -1;
+            if(current_element->framed && x->x_tablet && (x->x_multi_count == 0))
+            {
+                /* the whole frame goes out as one message after the scan */
+                if(!framed)
+                    ++emitted;
+                framed = 1;
+            }
+            else
+            {
+                ++emitted;
+                hidio_output_element(x, current_element, device_number, i);
+                ++stats->events_emitted;
+            }
+            if(pending[i] && (current_element->timestamp > 0))
+            {
+                if(system_time == 0)
+                    system_time = hidio_get_system_time();
+                hidio_count_latency(stats, system_time, current_element->timestamp);
+            }
+            previous[i] = values[i];
+            /* relative elements output the sum of the deltas of this tick,
+             * then start summing again from 0 */
+            if(hidio_element_relative[device_number][i])
+                values[i] = 0;
+            pending[i] = 0;
+        }
+    }
+    /* the rest of what was scanned was stored without changing the value */
+    if(stopped == 1)
+        memset(pending + start, 0, i - start);
+    else if(stopped)
+    {
+        memset(pending + start, 0, count - start);
+        memset(pending, 0, i);
+    }
+    else
+        memset(pending, 0, count);
+    hidio_output_start[device_number] = stopped ? i : 0;
+    if(framed)
+    {
+        hidio_output_frame(x);
+        ++stats->events_emitted;
+    }
+    /* a relative element that just moved still has its 0 to output */
+    return waiting || stopped || (emitted > 0);
+}
+
+/* [open-all( only reads the devices that have events waiting, and only
+ * scans those and the ones with output left over from the last tick */
+static void hidio_tick_multi(t_hidio *x, double right_now)
+{
+    unsigned char ready[MAX_MULTI_DEVICES];
+    unsigned char over_budget;
+    t_hidio_stats *stats;
+    int k;
+
+    memset(ready, 0, sizeof(ready));
+    hidio_get_ready_multi(x, ready);
+    for(k = 0; k < x->x_multi_count; ++k)
+    {
+        if( !ready[k] && !x->x_multi_active[k] )
+            continue;
+        hidio_select_multi(x, k);
+        stats = hidio_stats + x->x_device_number;
+        over_budget = ready[k] ? hidio_read_events(x, stats) : 0;
+        x->x_multi_active[k] = hidio_output_changes(x, stats, right_now, &over_budget);
+        if(over_budget)
+            ++stats->overflows;
+    }
+}
+
+static void hidio_tick(t_hidio *x)
+{
+    debug_post(LOG_DEBUG,"hidio_tick");
+    t_hidio_stats *stats;
+    unsigned char over_budget = 0;
+    double right_now;
+
+#ifdef PD
+    right_now = clock_getlogicaltime();
+#else /* Max */
+    clock_getftime(&right_now);
+#endif /* PD */
+
+//    debug_post(LOG_DEBUG,"# %u\tnow: %llu\tlast: %llu", x->x_device_number,
+//                right_now, hidio_last_execute_time[x->x_device_number]);
+    if(x->x_multi_count > 0)
+        hidio_tick_multi(x, right_now);
+    else
+    {
+        if(x->x_shm_name)
+            hidio_check_shm(x);
+        if(x->x_device_number < 0)
+            return;
+        stats = hidio_stats + x->x_device_number;
+        if(right_now > hidio_last_execute_time[x->x_device_number])
+        {
+            over_budget = hidio_read_events(x, stats);
+            hidio_last_execute_time[x->x_device_number] = right_now;
+/*        debug_post(LOG_DEBUG,"executing: instance %d/%d at %llu last: %llu", 
+             x->x_instance+1, hidio_instance_count, right_now,
+             hidio_last_execute_time[x->x_device_number]);*/
+        }
+        if(x->x_adaptive_max > 0)
+            hidio_adapt_delay(x, stats);
+        hidio_output_changes(x, stats, right_now, &over_budget);
+        if(over_budget)
+            ++stats->overflows;
+    }
+    /* in DSP sync mode, hidio_perform() schedules the next tick */
+    if (x->x_started && !x->x_dsp_sync) 
+    {
+        hidio_schedule_tick(x);
+    }
+}
+
+static void hidio_info(t_hidio *x)
+{
+    output_open_status(x);
+    output_device_number(x);
+    output_device_count(x);
+    output_poll_time(x);
+    output_element_ranges(x);
+    hidio_platform_specific_info(x);
+}
+
+static void hidio_float(t_hidio* x, t_floatarg f) 
 {
     debug_post(LOG_DEBUG,"hid_float");
 
@@ -565,10 +2292,57 @@ static void hidio_int(t_hidio* x, long l)
 }
 #endif /* NOT PD */
 
+/* [stats( outputs the counters, [stats reset( clears them */
+static void hidio_stats_message(t_hidio *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if(x->x_device_number < 0)
+        return;
+    if(atom_getsymbolarg(0, argc, argv) == gensym("reset"))
+        memset(hidio_stats + x->x_device_number, 0, sizeof(t_hidio_stats));
+    else
+        output_stats(x);
+}
+
+static void hidio_set_budget(t_hidio *x, t_int budget, t_hidio_overflow overflow)
+{
+    if(x->x_ring != NULL)
+        freebytes(x->x_ring, x->x_budget * sizeof(t_hidio_queued_event));
+    x->x_ring = NULL;
+    x->x_ring_start = x->x_ring_count = 0;
+    x->x_budget = budget;
+    x->x_overflow = overflow;
+    if(overflow == OVERFLOW_DROP)
+        x->x_ring = (t_hidio_queued_event *)getbytes(budget * sizeof(t_hidio_queued_event));
+}
+
+/* [budget 50( limits how many events are handled and output per poll */
+static void hidio_budget(t_hidio *x, t_floatarg f)
+{
+    t_int budget = (t_int)f;
+    if(budget < 1)
+        budget = 1;
+    else if(budget > MAX_EVENT_BUDGET)
+        budget = MAX_EVENT_BUDGET;
+    hidio_set_budget(x, budget, x->x_overflow);
+}
+
+/* [overflow defer|coalesce|drop( sets what happens to events over budget */
+static void hidio_overflow(t_hidio *x, t_symbol *s)
+{
+    if(s == gensym("defer"))
+        hidio_set_budget(x, x->x_budget, OVERFLOW_DEFER);
+    else if(s == gensym("coalesce"))
+        hidio_set_budget(x, x->x_budget, OVERFLOW_COALESCE);
+    else if(s == gensym("drop"))
+        hidio_set_budget(x, x->x_budget, OVERFLOW_DROP);
+    else
+        pd_error(x, "[hidio] overflow must be defer, coalesce, or drop");
+}
+
 static void hidio_debug(t_hidio *x, t_float f)
 {
     debug_post(LOG_INFO,"[hidio] set global debug level to %d", (int)f);
-    global_debug_level = f;
+    hidio_debug_level = f;
 }
 
 
@@ -579,32 +2353,58 @@ static void hidio_free(t_hidio* x)
 {
     debug_post(LOG_DEBUG,"hidio_free");
 
+    if(x->x_async_job != ASYNC_NONE)
+        hidio_async_discard(x);
+    clock_free(x->x_async_clock);
     hidio_close(x);
+    hidio_shm_close(x->x_shm);
     clock_free(x->x_clock);
     hidio_instance_count--;
 
+    hidio_set_budget(x, x->x_budget, OVERFLOW_COALESCE); /* frees the ring */
+    if(x->x_routes)
+        freebytes(x->x_routes, x->x_route_size * sizeof(t_hidio_route));
+    if(x->x_element_routes)
+        freebytes(x->x_element_routes, MAX_ELEMENTS * sizeof(t_hidio_route *));
     hidio_platform_specific_free(x);
+#ifdef PDINSTANCE
+    if(hidio_instance_count == 0)
+        hidio_free_context();
+#endif /* PDINSTANCE */
 }
 
 /* create a new instance of this class */
 static void *hidio_new(t_symbol *s, int argc, t_atom *argv) 
 {
     unsigned int i;
+    t_int j;
+    int device_argc;
+    t_atom *device_argv = (t_atom *)getbytes((argc + 1) * sizeof(t_atom));
 #ifdef PD
     t_hidio *x = (t_hidio *)pd_new(hidio_class);
     
     x->x_clock = clock_new(x, (t_method)hidio_tick);
+    x->x_async_clock = clock_new(x, (t_method)hidio_async_tick);
+    device_argc = hidio_parse_routes(x, argc, argv, device_argv);
 
     /* create anything outlet used for HID data */ 
     x->x_data_outlet = outlet_new(&x->x_obj, 0);
+    /* one float outlet per -out flag, between data and status */
+    for(j = 0; j < x->x_outlet_count; ++j)
+        x->x_routes[j].outlet = outlet_new(&x->x_obj, &s_float);
     x->x_status_outlet = outlet_new(&x->x_obj, 0);
 #else /* Max */
     t_hidio *x = (t_hidio *)object_alloc(hidio_class);
     
     x->x_clock = clock_new(x, (method)hidio_tick);
+    x->x_async_clock = clock_new(x, (method)hidio_async_tick);
+    device_argc = hidio_parse_routes(x, argc, argv, device_argv);
 
     /* create anything outlet used for HID data */ 
     x->x_status_outlet = outlet_new(x, "anything");
+    /* Max adds outlets from right to left */
+    for(j = x->x_outlet_count - 1; j >= 0; --j)
+        x->x_routes[j].outlet = outlet_new(x, "float");
     x->x_data_outlet = outlet_new(x, "anything");
 #endif /* PD */
 
@@ -612,11 +2412,29 @@ static void *hidio_new(t_symbol *s, int argc, t_atom *argv)
     x->x_device_open = 0;
     x->x_started = 0;
     x->x_delay = DEFAULT_DELAY;
-    for(i=0; i<MAX_DEVICES; ++i) last_execute_time[i] = 0;
+    x->x_dsp_sync = 0;
+    x->x_adaptive_max = 0;
+    x->x_ring = NULL;
+    hidio_set_budget(x, MAX_EVENTS_PER_POLL, OVERFLOW_COALESCE);
+    x->x_multi_count = 0;
+    x->x_composite = 0;
+    x->x_async = 0;
+    x->x_async_job = ASYNC_NONE;
+    x->x_tablet = 1;
+    x->x_normalize = 0;
+    x->x_shm = NULL;
+    for(i=0; i<HIDIO_SLOTS; ++i) hidio_last_execute_time[i] = 0;
 #ifdef _WIN32
     x->x_hid_device = hidio_platform_specific_new(x);
 #endif
-    x->x_device_number = get_device_number_from_arguments(argc, argv);
+    if(x->x_shm_name)
+    {
+        x->x_device_number = -1;
+        hidio_open_shm(x);
+    }
+    else
+        x->x_device_number = get_device_number_from_arguments(device_argc, device_argv);
+    freebytes(device_argv, (argc + 1) * sizeof(t_atom));
   
     x->x_instance = hidio_instance_count;
     hidio_instance_count++;
@@ -641,15 +2459,36 @@ void hidio_setup(void)
     
     /* add inlet message methods */
     class_addmethod(hidio_class,(t_method) hidio_debug,gensym("debug"),A_DEFFLOAT,0);
-    class_addmethod(hidio_class,(t_method) hidio_build_device_list,gensym("refresh"),0);
+    class_addmethod(hidio_class,(t_method) hidio_refresh,gensym("refresh"),0);
+    class_addmethod(hidio_class,(t_method) hidio_async,gensym("async"),A_FLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_tablet,gensym("tablet"),A_FLOAT,0);
 /* TODO: [print( should be dumped for [devices( and [elements( messages */
     class_addmethod(hidio_class,(t_method) hidio_devices,gensym("devices"),0);
     class_addmethod(hidio_class,(t_method) hidio_elements,gensym("elements"),0);
     class_addmethod (hidio_class, (t_method) hidio_print, gensym("print"), 0); // mp20200205
     class_addmethod(hidio_class,(t_method) hidio_info,gensym("info"),0);
     class_addmethod(hidio_class,(t_method) hidio_open,gensym("open"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_open_all,gensym("open-all"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_open_composite,gensym("open-composite"),A_GIMME,0);
     class_addmethod(hidio_class,(t_method) hidio_close,gensym("close"),0);
     class_addmethod(hidio_class,(t_method) hidio_poll,gensym("poll"),A_DEFFLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_stats_message,gensym("stats"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_filter,gensym("deadband"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_filter,gensym("hysteresis"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_filter,gensym("ratelimit"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_normalize,gensym("normalize"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_subscribe,gensym("subscribe"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_subscribe,gensym("unsubscribe"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_snapshot,gensym("snapshot"),0);
+    class_addmethod(hidio_class,(t_method) hidio_get,gensym("get"),A_SYMBOL,A_SYMBOL,A_DEFFLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_dspsync,gensym("dspsync"),A_FLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_adaptive,gensym("adaptive"),A_FLOAT,A_DEFFLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_budget,gensym("budget"),A_FLOAT,0);
+    class_addmethod(hidio_class,(t_method) hidio_overflow,gensym("overflow"),A_SYMBOL,0);
+    class_addmethod(hidio_class,(t_method) hidio_bind,gensym("bind"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_unbind,gensym("unbind"),A_GIMME,0);
+    class_addmethod(hidio_class,(t_method) hidio_publish,gensym("publish"),A_DEFSYM,0);
+    class_addmethod(hidio_class,(t_method) hidio_dsp,gensym("dsp"),A_CANT,0);
 
 /* test function for output support */
     class_addmethod(hidio_class,(t_method) hidio_write_event, gensym("write"), A_GIMME ,0);
@@ -659,15 +2498,13 @@ void hidio_setup(void)
          HIDIO_MAJOR_VERSION, HIDIO_MINOR_VERSION);  
     post("\tcompiled on "__DATE__" at "__TIME__ " ");
     
-    /* pre-generate often used symbols */
-    ps_open = gensym("open");
-    ps_device = gensym("device");
-    ps_poll = gensym("poll");
-    ps_total = gensym("total");
-    ps_range = gensym("range");
-
-    generate_type_symbols();
-    generate_event_symbols();
+#ifdef PDINSTANCE
+    /* each Pd instance sets up its own context on first use */
+    hidio_context_class = class_new(gensym("hidio context"), 0, 0, 
+                                    sizeof(t_hidio_context), CLASS_PD, 0);
+#else
+    hidio_init_context();
+#endif /* PDINSTANCE */
 }
 #else /* Max */
 static void hidio_notify(t_hidio *x, t_symbol *s, t_symbol *msg, void *sender, void *data)
@@ -688,8 +2525,12 @@ static void hidio_assist(t_hidio *x, void *b, long m, long a, char *s)
         case 0:
             sprintf(s, "(list) Received Events");
             break;
-        case 1:
-            sprintf(s, "(list) Status Info");
+        default:
+            if(a > x->x_outlet_count)
+                sprintf(s, "(list) Status Info");
+            else
+                sprintf(s, "(float) %s %s %d", x->x_routes[a-1].type->s_name,
+                        x->x_routes[a-1].name->s_name, (int)x->x_routes[a-1].instance);
             break;
         }
     }
@@ -727,15 +2568,32 @@ int main()
     
     /* add inlet message methods */
     class_addmethod(c, (method)hidio_debug, "debug",A_DEFFLOAT,0);
-    class_addmethod(c, (method)hidio_build_device_list, "refresh",0);
+    class_addmethod(c, (method)hidio_refresh, "refresh",0);
+    class_addmethod(c, (method)hidio_async, "async",A_FLOAT,0);
+    class_addmethod(c, (method)hidio_tablet, "tablet",A_FLOAT,0);
 /* TODO: [print( should be dumped for [devices( and [elements( messages */
     class_addmethod(c, (method)hidio_devices, "devices",0);
     class_addmethod(c, (method)hidio_elements, "elements",0);
     class_addmethod(c, (method)hidio_print, "print",0);
     class_addmethod(c, (method)hidio_info, "info",0);
     class_addmethod(c, (method)hidio_open, "open",A_GIMME,0);
+    class_addmethod(c, (method)hidio_open_all, "open-all",A_GIMME,0);
+    class_addmethod(c, (method)hidio_open_composite, "open-composite",A_GIMME,0);
     class_addmethod(c, (method)hidio_close, "close",0);
     class_addmethod(c, (method)hidio_poll, "poll",A_DEFFLOAT,0);
+    class_addmethod(c, (method)hidio_stats_message, "stats",A_GIMME,0);
+    class_addmethod(c, (method)hidio_filter, "deadband",A_GIMME,0);
+    class_addmethod(c, (method)hidio_filter, "hysteresis",A_GIMME,0);
+    class_addmethod(c, (method)hidio_filter, "ratelimit",A_GIMME,0);
+    class_addmethod(c, (method)hidio_normalize, "normalize",A_GIMME,0);
+    class_addmethod(c, (method)hidio_subscribe, "subscribe",A_GIMME,0);
+    class_addmethod(c, (method)hidio_subscribe, "unsubscribe",A_GIMME,0);
+    class_addmethod(c, (method)hidio_snapshot, "snapshot",0);
+    class_addmethod(c, (method)hidio_get, "get",A_SYM,A_SYM,A_DEFFLOAT,0);
+    class_addmethod(c, (method)hidio_adaptive, "adaptive",A_FLOAT,A_DEFFLOAT,0);
+    class_addmethod(c, (method)hidio_budget, "budget",A_FLOAT,0);
+    class_addmethod(c, (method)hidio_overflow, "overflow",A_SYM,0);
+    class_addmethod(c, (method)hidio_publish, "publish",A_DEFSYM,0);
     /* perfomrance / system stuff */
 
     class_addmethod(c, (method)hidio_assist,         "assist",         A_CANT, 0);  
@@ -755,15 +2613,7 @@ int main()
          HIDIO_MAJOR_VERSION, HIDIO_MINOR_VERSION);
     post("hidio: compiled on "__DATE__" at "__TIME__ " ");
     
-    /* pre-generate often used symbols */
-    ps_open = gensym("open");
-    ps_device = gensym("device");
-    ps_poll = gensym("poll");
-    ps_total = gensym("total");
-    ps_range = gensym("range");
-
-    generate_type_symbols();
-    generate_event_symbols();
+    hidio_init_context();
 
     return EXIT_SUCCESS;
 }
@@ -21,8 +21,12 @@
 
 #ifdef __linux__
 #include <linux/types.h>
+#include <pthread.h>
+#include "hidio_core.h"
 #endif /* __linux__ */
 
+#include "hidio_shm.h"
+
 #ifdef PD
 #include <m_pd.h>
 #else /* Max */
@@ -36,6 +40,7 @@ typedef double t_floatarg;
 typedef void t_outlet;
 typedef void t_clock;
 #define getbytes(s) malloc(s)
+#define resizebytes(p, o, n) realloc(p, n)
 #define freebytes(p, s) free(p)
 #define MAXPDSTRING 512
 #define pd_error(x, b) error(b)
@@ -61,22 +66,112 @@ typedef void t_clock;
  */
 
 #define DEFAULT_DELAY 5
+/* [adaptive( polls at the measured report rate but never faster than this,
+ * and backs off to ADAPTIVE_MAX_DELAY when idle unless told otherwise */
+#define ADAPTIVE_MIN_DELAY 1
+#define ADAPTIVE_MAX_DELAY 250
 
 /* this is set to simplify data structures (arrays instead of linked lists) */
 #define MAX_DEVICES 128
-
-/* I think 64 is the limit per device as defined in the OS <hans@at.or.at> */
-#define MAX_ELEMENTS 64
+/* [hidio -shm name] readers get their own device slots after the real
+ * devices, so the elements of a publisher never land on a local device */
+#define HIDIO_SHM_SLOTS 8
+#define HIDIO_SLOTS (MAX_DEVICES + HIDIO_SHM_SLOTS)
+/* devices one instance can read with [open-all( */
+#define MAX_MULTI_DEVICES 32
+
+/* 64 was thought to be the limit per device as defined in the OS, but a
+ * Linux keyboard reports several hundred keys, so leave room for those */
+#define MAX_ELEMENTS 512
+/* slots in the hash index of elements by type, name and instance, a power
+ * of 2 and at least twice MAX_ELEMENTS so that the probes stay short */
+#define ELEMENT_INDEX_SIZE 1024
 
 /* this is limited so that the object doesn't cause a click getting too many
  * events from the OS's event queue.  On Mac OS X, this is set in on the
  * kernel level in HID_Utilities_External.h with the constant
  * kDeviceQueueSize */
 #define MAX_EVENTS_PER_POLL 50
+/* upper limit for [budget( */
+#define MAX_EVENT_BUDGET 4096
+
+/* ms between checks whether the worker of [async 1( is done */
+#define ASYNC_POLL_DELAY 2
+
+/* what happens to events over the budget of one poll, see [overflow( */
+typedef enum _hidio_overflow
+{
+    OVERFLOW_DEFER,    /* leave them in the OS queue for the next poll */
+    OVERFLOW_COALESCE, /* read them all, output the latest per element */
+    OVERFLOW_DROP      /* read them all, keep only the newest ones */
+} t_hidio_overflow;
+
+/* an event held back by the OVERFLOW_DROP policy */
+typedef struct _hidio_queued_event
+{
+    struct _hid_element *queued_element;
+    t_int value;
+    double timestamp;
+} t_hidio_queued_event;
+
+
+/* the arguments of [open( in a form that hidio_resolve_open_args() can turn
+ * into a device number without any Pd calls, so also on a worker thread */
+typedef struct _hidio_open_args
+{
+    short device_number; /* from a float argument, or the resolved one */
+    unsigned int usage; /* usage_page << 16 + usage, 0 when not by usage */
+    unsigned short instance; /* of that usage */
+    unsigned short vendor_id; /* both ids 0 when not by id */
+    unsigned short product_id;
+} t_hidio_open_args;
+
+/* what the worker of [async 1( is busy with */
+typedef enum _hidio_async_job
+{
+    ASYNC_NONE,
+    ASYNC_OPEN,
+    ASYNC_REFRESH
+} t_hidio_async_job;
 
 
 /* -----------------------------------------------------------------------------
  *  CLASS DEF */
+/* an element given with -out when creating [hidio], it gets its own outlet,
+ * or one given with [bind(, which is sent straight to a receive name */
+typedef struct _hidio_route
+{
+    t_symbol *type;
+    t_symbol *name;
+    t_int instance;
+    t_outlet *outlet;
+    t_symbol *receiver;
+} t_hidio_route;
+
+#ifdef __linux__
+/* x, y, pressure, tilt x and y, and distance */
+#define TABLET_AXES 6
+/* BTN_TOOL_PEN to BTN_TOOL_LENS */
+#define TABLET_TOOLS 8
+
+/* the pen of a tablet, output as one frame per tick, see hidio_linux.c */
+typedef struct _hidio_tablet
+{
+    unsigned char has_pen; /* set on open, the device has BTN_TOOL_PEN */
+    int axis_ids[TABLET_AXES]; /* element ids, -1 if the tablet lacks one */
+    int tool_ids[TABLET_TOOLS];
+    int32_t frame[TABLET_AXES]; /* the axes received in this report */
+    unsigned char received[TABLET_AXES];
+    unsigned char tools_received; /* bit k is BTN_TOOL_PEN + k */
+    unsigned char tools_down;
+    t_symbol *tool_symbols[TABLET_TOOLS];
+    t_symbol *tool; /* in proximity, NULL when none is */
+    t_symbol *frame_tool; /* the tool of the last frame that was output */
+    t_symbol *stylus_symbol;
+    t_symbol *proximity_symbol;
+} t_hidio_tablet;
+#endif /* __linux__ */
+
 typedef struct _hidio 
 {
 	t_object            x_obj;
@@ -87,7 +182,11 @@ typedef struct _hidio
 	void				*x_hid_device;
 #endif 
 #ifdef __linux__
-	t_int               x_fd;
+	t_hidio_core_device *x_core; /* NULL when closed */
+	t_hidio_core_device *x_multi_cores[MAX_MULTI_DEVICES];
+	int                 x_epoll_fd;
+	struct _linux_async *x_async_work; /* shared with the worker of [async 1( */
+	t_hidio_tablet      x_pen;
 #endif 
 	void                *x_ff_device;
 	short               x_device_number;
@@ -95,10 +194,38 @@ typedef struct _hidio
 	t_int               x_has_ff;
 	t_int               x_started;
 	t_int               x_device_open;
-	t_int               x_delay;
+	t_float             x_delay; /* ms between polls */
+	t_int               x_dsp_sync; /* poll once per DSP block instead */
+	t_float             x_adaptive_max; /* idle poll limit, 0 means not adaptive */
+	t_float             x_adaptive_delay; /* current delay when adaptive */
+	t_int               x_budget; /* events per poll, MAX_EVENTS_PER_POLL */
+	t_hidio_overflow    x_overflow;
+	t_hidio_queued_event *x_ring; /* newest x_budget events for OVERFLOW_DROP */
+	t_int               x_ring_start;
+	t_int               x_ring_count;
+	short               x_multi_devices[MAX_MULTI_DEVICES]; /* [open-all( */
+	unsigned char       x_multi_active[MAX_MULTI_DEVICES]; /* needs a scan */
+	t_int               x_multi_count; /* 0 unless in multi-device mode */
+	unsigned char       x_composite; /* [open-composite(, output as one device */
+	t_int               x_async; /* [async 1(, open and refresh on a worker thread */
+	t_hidio_async_job   x_async_job;
+	t_hidio_open_args   x_async_args;
+	t_clock             *x_async_clock; /* checks for the worker to finish */
+	t_int               x_tablet; /* [tablet 0( turns the [stylus( frames off */
+	t_int               x_normalize; /* apply [normalize( to each opened device */
+	t_float             x_normalize_low;
+	t_float             x_normalize_high;
 	t_clock             *x_clock;
 	t_outlet            *x_data_outlet;
 	t_outlet            *x_status_outlet;
+	t_hidio_route       *x_routes; /* -out flags first, then [bind( */
+	t_int               x_route_count;
+	t_int               x_route_size; /* routes allocated in x_routes */
+	t_int               x_outlet_count; /* number of -out flags */
+	t_hidio_route       **x_element_routes; /* element number to route */
+	t_hidio_shm         *x_shm; /* written by [publish(, or read with -shm */
+	t_symbol            *x_shm_name; /* -shm name, NULL when reading a device */
+	short               x_shm_device_number; /* of the publisher, for [device N( */
 } t_hidio;
 
 
@@ -107,15 +234,9 @@ typedef struct _hidio
  *  GLOBAL VARIABLES
  */
 
-/* count the number of instances of this object so that certain free()
- * functions can be called only after the final instance is detroyed.
- */
-extern t_int hidio_instance_count;
-
-/* this is used to test for the first instance to execute */
-extern double last_execute_time[MAX_DEVICES];
+/* the state shared by all instances of [hidio] is kept per Pd instance in
+ * t_hidio_context, see below */
 
-extern unsigned short global_debug_level;
 
 /* built up when the elements of an open device are enumerated */
 typedef struct _hid_element
@@ -141,36 +262,50 @@ typedef struct _hid_element
     t_int max; /* from device report */
     t_float instance; /* usage page/usage instance # (e.g. [absolute x 2 163( */
 	t_atom output_message[3]; /* pre-generated message for hidio_output_event */
-#ifdef _WIN32
-    long value; // mp20200205 HidP_GetUsageValue wants ulong
-#else
-    t_int value; /* output the sum of events in a poll for relative axes */
-#endif /* _WIN32 */
-    t_int previous_value; /*only output on change on abs and buttons */
+    /* the value, the previous value and the pending flag are kept in the
+     * hidio_element_values etc. arrays, at [device_number][id] */
+    double timestamp; /* system time in ms of the last event, 0 if unknown */
+    /* filtering for noisy absolute axes, set with [deadband(, [hysteresis(
+     * and [ratelimit(, all 0 means no filtering */
+    t_int deadband; /* ignore changes up to this size from the last output */
+    t_int hysteresis; /* ignore reversals up to this size */
+    signed char direction; /* direction of the last output change: -1 0 1 */
+    double min_interval; /* ms between outputs, the latest value waits */
+    double last_output_time; /* logical time of the last output */
+    unsigned char subscribed; /* set by [subscribe( */
+    unsigned char framed; /* output together by hidio_output_frame() */
+    /* set by [normalize(: output value * scale + offset, 0 scale is raw */
+    t_float scale;
+    t_float offset;
+    short device_number; /* set by hidio_build_element_index() */
+    unsigned short id; /* index in hidio_element_table[device_number] */
 } t_hid_element;
 
-/* mostly for status querying */
-extern unsigned short device_count;
+/* number of buckets in the event latency histogram, the upper limits are
+ * 0.5 1 2 4 8 16 32 ms, the last one counts everything over that */
+#define LATENCY_BUCKETS 8
 
-/* store element structs to eliminate symbol table lookups, etc. */
-extern t_hid_element *element[MAX_DEVICES][MAX_ELEMENTS];
-/* number of active elements per device */
-extern unsigned short element_count[MAX_DEVICES]; 
-
-
-/* Each instance registers itself with a hidio_instances[] linked list when it
- * opens a device.  Whichever instance gets the events from the OS will then
- * go thru this linked list and call its output function. */
-
-/* basic element of a linked list of hidio instances */
-typedef struct _hidio_instance
+/* counters kept per device by hidio_element_update() and hidio_tick(), they
+ * are only ever incremented so they can be left on all the time */
+typedef struct _hidio_stats
 {
-    t_hidio *x;
-    struct _hidio_instance *x_next;
-} t_hidio_instance;
+    unsigned long events_read; /* events fetched from the OS */
+    unsigned long events_emitted; /* events output by hidio_tick() */
+    unsigned long events_coalesced; /* overwritten before they were output */
+    unsigned long events_filtered; /* dropped by [deadband( or [hysteresis( */
+    unsigned long read_calls; /* read() syscalls, GNU/Linux only */
+    unsigned long resyncs; /* OS queue overflows followed by a resync */
+    unsigned long empty_ticks; /* polls that found no events */
+    unsigned long max_events_per_tick;
+    unsigned long tick_events; /* events read in the current poll */
+    double last_report_time; /* timestamp of the last report */
+    double report_interval; /* smoothed time between reports in ms */
+    unsigned long overflows; /* polls that went over the budget */
+    unsigned long events_dropped; /* by OVERFLOW_DROP */
+    unsigned long latency[LATENCY_BUCKETS]; /* event timestamp to output */
+} t_hidio_stats;
+
 
-/* array of linked lists of instances wanting events from a given device. */
-extern t_hidio_instance *hidio_instances[MAX_DEVICES]; 
 
 
 /*------------------------------------------------------------------------------
@@ -181,6 +316,15 @@ extern t_hidio_instance *hidio_instances[MAX_DEVICES];
 void debug_post(t_int debug_level, const char *fmt, ...);
 void debug_error(t_hidio *x, t_int debug_level, const char *fmt, ...);
 void hidio_output_event(t_hidio *x, t_hid_element *output_data);
+t_float hidio_output_value(t_hid_element *output_element);
+t_hid_element *hidio_find_element(short device_number, t_symbol *type,
+                                  t_symbol *name, t_int instance);
+void hidio_clear_element_values(short device_number);
+void hidio_element_update(t_hidio *x, t_hid_element *updated_element,
+                          t_int value, double timestamp);
+int hidio_events_wanted(t_hidio *x);
+short hidio_resolve_open_args(t_hidio_open_args *args);
+double hidio_get_system_time(void);
 
 
 /* generic, cross-platform functions implemented in a separate file for each
@@ -200,9 +344,36 @@ extern void hidio_devices(t_hidio* x); /* print device list to the console */
 extern void hidio_elements(t_hidio* x); /* print element list to the console */
 extern void hidio_print(t_hidio* x); /* print info to the console */
 extern void hidio_platform_specific_info(t_hidio *x); /* device info on the status outlet */
+/* output the framed elements of the current device as one message, called
+ * once per tick when any of them changed */
+extern void hidio_output_frame(t_hidio *x);
 extern void hidio_platform_specific_free(t_hidio *x);
+/* tell the OS which events to send based on the subscribed elements */
+extern void hidio_set_event_mask(t_hidio *x);
 extern void *hidio_platform_specific_new(t_hidio *x);
 extern short get_device_number_by_id(unsigned short vendor_id, unsigned short product_id);
+/* multi-device mode, [open-all( opens all of x_multi_devices at once and
+ * returns how many it could open, keeping only those in the list */
+extern t_int hidio_open_multi(t_hidio *x);
+extern void hidio_close_multi(t_hidio *x);
+/* flag the devices with events waiting, returns how many there are */
+extern int hidio_get_ready_multi(t_hidio *x, unsigned char *ready);
+/* make a device of the list current for hidio_get_events() */
+extern void hidio_select_multi(t_hidio *x, int index);
+/* fills siblings with device_number and the other nodes of the same physical
+ * device, returns how many there are */
+extern t_int hidio_get_siblings(short device_number, short *siblings);
+/* [async 1(, the blocking part of open and refresh runs on a worker thread.
+ * Both return EXIT_FAILURE when this platform has no worker */
+extern t_int hidio_async_open(t_hidio *x);
+extern t_int hidio_async_refresh(t_hidio *x);
+/* non-zero once the worker is done */
+extern t_int hidio_async_done(t_hidio *x);
+/* the main thread half of the job, returns like hidio_open_device() */
+extern t_int hidio_async_finish(t_hidio *x);
+/* throw away what the worker found, or leave it to the worker to do that
+ * when it is still busy, never blocks */
+extern void hidio_async_discard(t_hidio *x);
 /* TODO: this function should probably accept the single unsigned for the combined usage_page and usage, instead of two separate variables */
 extern short get_device_number_from_usage(short device_number, 
 										unsigned short usage_page, 
@@ -222,19 +393,122 @@ extern short get_device_number_from_usage(short device_number,
 
 
 /*==============================================================================
- * symbol pointers for pre-generated event symbols
+ * state shared by all instances of [hidio] in one Pd instance
  *============================================================================*/
 
-extern t_symbol *ps_absolute, *ps_button, *ps_key, *ps_led, *ps_pid, *ps_relative;
+/* With PDINSTANCE, i.e. libpd or plugin hosts, several Pd instances can run
+ * in one process, each with its own symbol table and maybe its own thread.
+ * They each get one of these, like Pd's own pd_this.  Otherwise there is a
+ * single static one.  The hidio_ names below are macros into it, prefixed so
+ * that they never take over the names of locals or of system headers. */
+#ifdef __GNUC__
+#define HIDIO_ALIGNED __attribute__((aligned(32)))
+#else
+#define HIDIO_ALIGNED
+#endif /* __GNUC__ */
+
+typedef struct _hidio_context
+{
+#ifdef PDINSTANCE
+    t_pd c_pd; /* bound to #hidio_context in the symbol table of its instance */
+#endif /* PDINSTANCE */
+    /* count the number of instances of this object so that certain free()
+     * functions can be called only after the final instance is detroyed. */
+    t_int c_instance_count;
+    unsigned short c_debug_level; /* high numbers means more messages */
+    /* this is used to test for the first instance to execute */
+    double c_last_execute_time[HIDIO_SLOTS];
+    /* mostly for status querying */
+    unsigned short c_device_count;
+    /* store element structs to eliminate symbol table lookups, etc. */
+    t_hid_element *c_element[HIDIO_SLOTS][MAX_ELEMENTS];
+    /* the state hidio_tick() scans, apart from the rest of t_hid_element so
+     * that it is contiguous and can be compared 4 or 8 elements at a time.
+     * Relative elements output the sum of the events in a poll as value */
+    int32_t c_element_value[HIDIO_SLOTS][MAX_ELEMENTS] HIDIO_ALIGNED;
+    int32_t c_element_previous[HIDIO_SLOTS][MAX_ELEMENTS] HIDIO_ALIGNED;
+    int32_t c_element_relative[HIDIO_SLOTS][MAX_ELEMENTS] HIDIO_ALIGNED; /* -1 or 0 */
+    /* a new value was stored but not output yet */
+    unsigned char c_element_pending[HIDIO_SLOTS][MAX_ELEMENTS];
+    /* element to start output from on the next tick when over the budget */
+    unsigned short c_output_start[HIDIO_SLOTS];
+    /* number of active elements per device */
+    unsigned short c_element_count[HIDIO_SLOTS]; 
+    /* number of subscribed elements per device, 0 means all events get thru */
+    unsigned short c_subscribed_count[HIDIO_SLOTS];
+    /* hash index into hidio_element_table[] by type, name and instance,
+     * built on open.  Each slot holds the element number + 1, 0 for empty */
+    unsigned short c_element_index[HIDIO_SLOTS][ELEMENT_INDEX_SIZE];
+    /* event counters per device, output with [stats( */
+    t_hidio_stats c_stats[HIDIO_SLOTS];
+    /* the reader in each of the HIDIO_SHM_SLOTS, NULL when free */
+    t_hidio *c_shm_readers[HIDIO_SHM_SLOTS];
+    /* pre-generated symbols, symbols belong to a Pd instance too */
+    t_symbol *c_ps_open, *c_ps_device, *c_ps_poll, *c_ps_total, *c_ps_range;
+    t_symbol *c_ps_stats, *c_ps_snapshot;
+    t_symbol *c_ps_absolute, *c_ps_button, *c_ps_key, *c_ps_led, *c_ps_pid;
+    t_symbol *c_ps_relative;
+    /* event symbols, NULL until first used, see hidio_key_symbol() etc. */
+    t_symbol *c_absolute_symbols[ABSOLUTE_ARRAY_MAX];
+    t_symbol *c_button_symbols[BUTTON_ARRAY_MAX];
+    t_symbol *c_key_symbols[KEY_ARRAY_MAX];
+    t_symbol *c_led_symbols[LED_ARRAY_MAX];
+    t_symbol *c_pid_symbols[PID_ARRAY_MAX];
+    t_symbol *c_relative_symbols[RELATIVE_ARRAY_MAX];
+} t_hidio_context;
+
+#ifdef PDINSTANCE
+#ifndef PERTHREAD
+#define PERTHREAD
+#endif /* NOT PERTHREAD */
+/* the context of the last Pd instance seen on this thread, so that finding
+ * it is just a compare unless the thread switched instances */
+extern PERTHREAD t_pdinstance *hidio_context_owner;
+extern PERTHREAD t_hidio_context *hidio_context_current;
+t_hidio_context *hidio_find_context(void);
+#define hidio_this ((hidio_context_owner == pd_this) ? \
+                    hidio_context_current : hidio_find_context())
+#else
+extern t_hidio_context hidio_context;
+#define hidio_this (&hidio_context)
+#endif /* PDINSTANCE */
+
+#define hidio_instance_count (hidio_this->c_instance_count)
+#define hidio_debug_level (hidio_this->c_debug_level)
+#define hidio_last_execute_time (hidio_this->c_last_execute_time)
+#define hidio_device_count (hidio_this->c_device_count)
+#define hidio_element_table (hidio_this->c_element)
+#define hidio_element_values (hidio_this->c_element_value)
+#define hidio_element_previous (hidio_this->c_element_previous)
+#define hidio_element_relative (hidio_this->c_element_relative)
+#define hidio_element_pending (hidio_this->c_element_pending)
+/* the value of an element after hidio_build_element_index() */
+#define ELEMENT_VALUE(e) (hidio_element_values[(e)->device_number][(e)->id])
+#define ELEMENT_PREVIOUS(e) (hidio_element_previous[(e)->device_number][(e)->id])
+#define hidio_output_start (hidio_this->c_output_start)
+#define hidio_element_count (hidio_this->c_element_count)
+#define hidio_subscribed_count (hidio_this->c_subscribed_count)
+#define hidio_element_index (hidio_this->c_element_index)
+#define hidio_stats (hidio_this->c_stats)
 
-extern t_symbol *absolute_symbols[ABSOLUTE_ARRAY_MAX];
-extern t_symbol *button_symbols[BUTTON_ARRAY_MAX];
-extern t_symbol *key_symbols[KEY_ARRAY_MAX];
-extern t_symbol *led_symbols[LED_ARRAY_MAX];
-extern t_symbol *pid_symbols[PID_ARRAY_MAX];
-extern t_symbol *relative_symbols[RELATIVE_ARRAY_MAX];
+/*==============================================================================
+ * symbol pointers for pre-generated event symbols
+ *============================================================================*/
 
-extern void generate_event_symbols();
+#define ps_absolute (hidio_this->c_ps_absolute)
+#define ps_button (hidio_this->c_ps_button)
+#define ps_key (hidio_this->c_ps_key)
+#define ps_led (hidio_this->c_ps_led)
+#define ps_pid (hidio_this->c_ps_pid)
+#define ps_relative (hidio_this->c_ps_relative)
+
+/* the event symbols are made on demand, use these instead of the arrays */
+extern t_symbol *hidio_absolute_symbol(unsigned int usage);
+extern t_symbol *hidio_button_symbol(unsigned int usage);
+extern t_symbol *hidio_key_symbol(unsigned int usage);
+extern t_symbol *hidio_led_symbol(unsigned int usage);
+extern t_symbol *hidio_pid_symbol(unsigned int usage);
+extern t_symbol *hidio_relative_symbol(unsigned int usage);
 extern void generate_type_symbols();
 
 
@@ -0,0 +1,119 @@
+#ifndef _HIDIO_CORE_H
+#define _HIDIO_CORE_H
+
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* libhidio_core: the GNU/Linux evdev part of [hidio] without Pd or Max.     */
+/* It opens and enumerates /dev/input/event* devices, keeps a table of the   */
+/* elements of each device with integer IDs, and reads the events either     */
+/* thru a callback or into an array.  hidio_linux.c is the Pd/Max wrapper,   */
+/* other hosts can use it directly: `make core` builds libhidio_core.a       */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <linux/input.h>
+
+/* /dev/input/event0 to /dev/input/event127 */
+#define HIDIO_CORE_MAX_DEVICES 128
+/* a Linux keyboard reports several hundred keys */
+#define HIDIO_CORE_MAX_ELEMENTS 512
+#define HIDIO_CORE_NAME_SIZE 256
+/* struct input_events fetched per read() syscall */
+#define HIDIO_CORE_READ_BATCH 64
+/* the id of SYN_REPORT events, see report_events */
+#define HIDIO_CORE_REPORT 0xffff
+
+/* one axis, key, button, LED, etc. of a device */
+typedef struct _hidio_core_element
+{
+    unsigned short id; /* index into the elements of the device */
+    unsigned short type; /* event type from linux/input.h, EV_KEY, EV_ABS, ... */
+    unsigned short code; /* event code, KEY_A, ABS_X, ... */
+    int min; /* range of absolute axes, 0 otherwise */
+    int max;
+    int value; /* the last value read, or the state when opened */
+} t_hidio_core_element;
+
+typedef struct _hidio_core_event
+{
+    unsigned short id; /* of the element */
+    unsigned short type;
+    unsigned short code;
+    int value;
+    double timestamp; /* CLOCK_MONOTONIC in ms, see hidio_core_time() */
+} t_hidio_core_event;
+
+typedef struct _hidio_core_device
+{
+    int fd;
+    int device_number; /* N of /dev/input/eventN, -1 if opened from an fd */
+    char name[HIDIO_CORE_NAME_SIZE];
+    unsigned int num_elements;
+    t_hidio_core_element elements[HIDIO_CORE_MAX_ELEMENTS]; /* sorted by type, code */
+    unsigned long read_calls; /* read() syscalls */
+    unsigned long resyncs; /* kernel buffer overflows followed by a resync */
+    int report_events; /* also deliver SYN_REPORT, with id HIDIO_CORE_REPORT */
+    /* the rest is private */
+    int syn_dropped; /* skip events until the next SYN_REPORT */
+    int sync_pending; /* the callback stopped a resync halfway */
+    struct input_event buffer[HIDIO_CORE_READ_BATCH];
+    unsigned int buffer_start;
+    unsigned int buffer_count;
+} t_hidio_core_device;
+
+/* called for each event, return 0 to stop reading, the events that were not
+ * delivered yet stay queued for the next hidio_core_read() */
+typedef int (*t_hidio_core_callback)(void *userdata, t_hidio_core_device *device,
+                                     const t_hidio_core_event *event);
+
+/* enumeration: 0 and the name if there is a device on /dev/input/event<N>,
+ * -1 if not.  Opens the device, so it can block on slow devices. */
+int hidio_core_device_name(int device_number, char *name, size_t size);
+
+/* open /dev/input/event<N>, enumerate its elements and read their current
+ * state.  Returns NULL and sets errno on failure. */
+t_hidio_core_device *hidio_core_open(int device_number);
+/* the same for an fd that is already open, it is closed by hidio_core_close().
+ * The fd is switched to O_NONBLOCK if it is not already */
+t_hidio_core_device *hidio_core_open_fd(int fd, int device_number);
+void hidio_core_close(t_hidio_core_device *device);
+
+/* add an element by hand, e.g. for devices on a pipe.  They have to be added
+ * in ascending type, code order.  Returns the id or -1. */
+int hidio_core_add_element(t_hidio_core_device *device, unsigned short type,
+                           unsigned short code, int min, int max);
+/* the id of the element for an event type and code, -1 if there is none */
+int hidio_core_find_element(t_hidio_core_device *device, unsigned short type,
+                            unsigned short code);
+
+/* deliver the waiting events to callback without blocking, returns how many
+ * were delivered or -1 on a read error.  Events of unknown elements and
+ * EV_SYN frames are not delivered, unless report_events is set: then each
+ * SYN_REPORT is delivered too, e.g. to handle a report as a whole.  After
+ * the kernel dropped events, the state is read again and the elements that
+ * changed are delivered. */
+int hidio_core_read(t_hidio_core_device *device, t_hidio_core_callback callback,
+                    void *userdata);
+/* the same, pulling up to max_events into events */
+int hidio_core_read_events(t_hidio_core_device *device, t_hidio_core_event *events,
+                           int max_events);
+/* read the state of keys, LEDs, switches and absolute axes and deliver the
+ * elements that differ from the last value, returns how many */
+int hidio_core_sync(t_hidio_core_device *device, t_hidio_core_callback callback,
+                    void *userdata);
+
+/* send one event followed by a SYN_REPORT, e.g. to set LEDs, 0 or -1 */
+int hidio_core_write(t_hidio_core_device *device, unsigned short type,
+                     unsigned short code, int value);
+/* only let the elements with a non-zero wanted[id] thru, NULL for all of
+ * them.  Needs EVIOCSMASK (Linux 4.4), -1 if the kernel can not do it */
+int hidio_core_set_event_mask(t_hidio_core_device *device,
+                              const unsigned char *wanted);
+
+/* ms on CLOCK_MONOTONIC, the clock the events are stamped with */
+double hidio_core_time(void);
+
+#endif  /* NOT _HIDIO_CORE_H */
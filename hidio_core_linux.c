@@ -0,0 +1,453 @@
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* libhidio_core for GNU/Linux evdev, see hidio_core.h                       */
+/*                                                                           */
+/* Nothing in here knows about Pd or Max, and nothing uses global state, so  */
+/* each device can be used from its own thread.                              */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+/* this code only works for Linux kernels */
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "hidio_core.h"
+
+#define LINUX_BLOCK_DEVICE   "/dev/input/event"
+
+/* from asm/types.h and linux/input.h __kernel__ sections */
+#define BITS_PER_LONG (sizeof(long) * 8)
+#define NBITS(x) (((x)/BITS_PER_LONG)+1)
+#define LONG(x) ((x)/BITS_PER_LONG)
+#define test_bit(bit, array)	((array[LONG(bit)] >> (bit%BITS_PER_LONG)) & 1)
+
+
+double hidio_core_time(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec * 0.000001;
+}
+
+/* hidio_core_open_fd() switches the event clock to CLOCK_MONOTONIC, so this
+ * is in the same timebase as hidio_core_time() */
+static double input_event_time(const struct input_event *event)
+{
+    return (double)event->time.tv_sec * 1000.0 + (double)event->time.tv_usec * 0.001;
+}
+
+
+/* ------------------------------------------------------------------------------ */
+/* ELEMENTS */
+/* ------------------------------------------------------------------------------ */
+
+int hidio_core_add_element(t_hidio_core_device *device, unsigned short type,
+                           unsigned short code, int min, int max)
+{
+    t_hidio_core_element *new_element;
+    t_hidio_core_element *last_element;
+
+    if(device->num_elements >= HIDIO_CORE_MAX_ELEMENTS)
+        return -1;
+    if(device->num_elements > 0)
+    {
+        /* hidio_core_find_element() does a binary search */
+        last_element = device->elements + device->num_elements - 1;
+        if( (type < last_element->type) ||
+            ((type == last_element->type) && (code <= last_element->code)) )
+            return -1;
+    }
+    new_element = device->elements + device->num_elements;
+    new_element->id = device->num_elements;
+    new_element->type = type;
+    new_element->code = code;
+    new_element->min = min;
+    new_element->max = max;
+    new_element->value = 0;
+    return device->num_elements++;
+}
+
+int hidio_core_find_element(t_hidio_core_device *device, unsigned short type,
+                            unsigned short code)
+{
+    t_hidio_core_element *current_element;
+    int low = 0;
+    int high = (int)device->num_elements - 1;
+    int middle;
+
+    while(low <= high)
+    {
+        middle = (low + high) / 2;
+        current_element = device->elements + middle;
+        if( (current_element->type < type) ||
+            ((current_element->type == type) && (current_element->code < code)) )
+            low = middle + 1;
+        else if( (current_element->type == type) && (current_element->code == code) )
+            return middle;
+        else
+            high = middle - 1;
+    }
+    return -1;
+}
+
+/* every type and code the device reports, in ascending order */
+static void core_enumerate(t_hidio_core_device *device)
+{
+    unsigned long type_bits[NBITS(EV_MAX)];
+    unsigned long code_bits[NBITS(KEY_MAX)];
+    struct input_absinfo abs_info;
+    unsigned int type, code;
+    int min, max;
+
+    memset(type_bits, 0, sizeof(type_bits));
+    if(ioctl(device->fd, EVIOCGBIT(0, sizeof(type_bits)), type_bits) < 0)
+        return;
+    /* type 0 is EV_SYN, which only frames the others */
+    for(type = 1; type < EV_MAX; ++type)
+    {
+        if(!test_bit(type, type_bits))
+            continue;
+        memset(code_bits, 0, sizeof(code_bits));
+        ioctl(device->fd, EVIOCGBIT(type, sizeof(code_bits)), code_bits);
+        for(code = 0; code < KEY_MAX; ++code)
+        {
+            if(!test_bit(code, code_bits))
+                continue;
+            min = max = 0;
+            if( (type == EV_ABS) && (code < ABS_CNT) &&
+                (ioctl(device->fd, EVIOCGABS(code), &abs_info) == 0) )
+            {
+                min = abs_info.minimum;
+                max = abs_info.maximum;
+            }
+            if(hidio_core_add_element(device, type, code, min, max) < 0)
+                return; /* the table is full */
+        }
+    }
+}
+
+
+/* ------------------------------------------------------------------------------ */
+/* DEVICES */
+/* ------------------------------------------------------------------------------ */
+
+int hidio_core_device_name(int device_number, char *name, size_t size)
+{
+    char block_device[FILENAME_MAX];
+    int fd;
+
+    snprintf(block_device, FILENAME_MAX, "%s%d", LINUX_BLOCK_DEVICE, device_number);
+    /* open the device read-only, non-exclusive */
+    fd = open(block_device, O_RDONLY | O_NONBLOCK);
+    if(fd < 0)
+        return -1;
+    memset(name, 0, size);
+    if(ioctl(fd, EVIOCGNAME(size - 1), name) < 1)
+        snprintf(name, size, "Unknown");
+    close(fd);
+    return 0;
+}
+
+t_hidio_core_device *hidio_core_open_fd(int fd, int device_number)
+{
+    t_hidio_core_device *device;
+    struct input_event flushed_event;
+    int flags;
+#ifdef EVIOCSCLOCKID
+    int clock_id = CLOCK_MONOTONIC;
+#endif /* EVIOCSCLOCKID */
+
+    device = (t_hidio_core_device *)calloc(1, sizeof(t_hidio_core_device));
+    if(device == NULL)
+        return NULL;
+    device->fd = fd;
+    device->device_number = device_number;
+    /* hidio_core_read() must never wait for events */
+    flags = fcntl(fd, F_GETFL);
+    if( (flags > -1) && !(flags & O_NONBLOCK) )
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+#ifdef EVIOCSCLOCKID
+    /* timestamp events with the clock of hidio_core_time(), this fails on
+     * kernels before 3.4, then the timestamps are off */
+    ioctl(fd, EVIOCSCLOCKID, &clock_id);
+#endif /* EVIOCSCLOCKID */
+    /* flush the events queued before the device was opened */
+    while(read(fd, &flushed_event, sizeof(struct input_event)) > 0);
+    if(ioctl(fd, EVIOCGNAME(HIDIO_CORE_NAME_SIZE - 1), device->name) < 1)
+        snprintf(device->name, HIDIO_CORE_NAME_SIZE, "Unknown");
+    core_enumerate(device);
+    /* start from the real positions of faders, switches, etc. */
+    hidio_core_sync(device, NULL, NULL);
+    return device;
+}
+
+t_hidio_core_device *hidio_core_open(int device_number)
+{
+    char block_device[FILENAME_MAX];
+    t_hidio_core_device *device;
+    int fd;
+
+    snprintf(block_device, FILENAME_MAX, "%s%d", LINUX_BLOCK_DEVICE, device_number);
+    /* read-write for LEDs and force feedback, non-exclusive */
+    fd = open(block_device, O_RDWR | O_NONBLOCK);
+    if(fd < 0)
+        return NULL;
+    device = hidio_core_open_fd(fd, device_number);
+    if(device == NULL)
+        close(fd);
+    return device;
+}
+
+void hidio_core_close(t_hidio_core_device *device)
+{
+    if(device == NULL)
+        return;
+    if(device->fd > -1)
+        close(device->fd);
+    free(device);
+}
+
+
+/* ------------------------------------------------------------------------------ */
+/* EVENTS */
+/* ------------------------------------------------------------------------------ */
+
+int hidio_core_sync(t_hidio_core_device *device, t_hidio_core_callback callback,
+                    void *userdata)
+{
+    unsigned long key_bits[NBITS(KEY_CNT)];
+    unsigned long led_bits[NBITS(LED_CNT)];
+    unsigned long switch_bits[NBITS(SW_CNT)];
+    struct input_absinfo abs_info;
+    t_hidio_core_element *current_element;
+    t_hidio_core_event core_event;
+    double now = hidio_core_time();
+    int value, delivered = 0;
+    unsigned int i;
+
+    device->sync_pending = 0;
+    memset(key_bits, 0, sizeof(key_bits));
+    memset(led_bits, 0, sizeof(led_bits));
+    memset(switch_bits, 0, sizeof(switch_bits));
+    ioctl(device->fd, EVIOCGKEY(sizeof(key_bits)), key_bits);
+    ioctl(device->fd, EVIOCGLED(sizeof(led_bits)), led_bits);
+    ioctl(device->fd, EVIOCGSW(sizeof(switch_bits)), switch_bits);
+    for(i = 0; i < device->num_elements; ++i)
+    {
+        current_element = device->elements + i;
+        /* relative axes and misc events have no state */
+        switch(current_element->type)
+        {
+        case EV_KEY:
+            value = test_bit(current_element->code, key_bits);
+            break;
+        case EV_LED:
+            value = test_bit(current_element->code, led_bits);
+            break;
+        case EV_SW:
+            value = test_bit(current_element->code, switch_bits);
+            break;
+        case EV_ABS:
+            if(ioctl(device->fd, EVIOCGABS(current_element->code), &abs_info) < 0)
+                continue;
+            value = abs_info.value;
+            break;
+        default:
+            continue;
+        }
+        if(value == current_element->value)
+            continue;
+        current_element->value = value;
+        if(callback == NULL)
+            continue;
+        core_event.id = current_element->id;
+        core_event.type = current_element->type;
+        core_event.code = current_element->code;
+        core_event.value = value;
+        core_event.timestamp = now;
+        ++delivered;
+        if(!callback(userdata, device, &core_event))
+        {
+            /* the next hidio_core_read() carries on from here */
+            device->sync_pending = 1;
+            break;
+        }
+    }
+    return delivered;
+}
+
+int hidio_core_read(t_hidio_core_device *device, t_hidio_core_callback callback,
+                    void *userdata)
+{
+    struct input_event *event;
+    t_hidio_core_event core_event;
+    ssize_t bytes;
+    int id, delivered = 0;
+
+    if(device->sync_pending)
+    {
+        delivered += hidio_core_sync(device, callback, userdata);
+        if(device->sync_pending)
+            return delivered;
+    }
+    for(;;)
+    {
+        if(device->buffer_count == 0)
+        {
+            ++device->read_calls;
+            bytes = read(device->fd, device->buffer, sizeof(device->buffer));
+            if(bytes < (ssize_t)sizeof(struct input_event))
+                return ((bytes < 0) && (errno != EAGAIN) && (delivered == 0)) ?
+                    -1 : delivered;
+            device->buffer_start = 0;
+            device->buffer_count = bytes / sizeof(struct input_event);
+        }
+        event = device->buffer + device->buffer_start;
+        ++device->buffer_start;
+        --device->buffer_count;
+        if(event->type == EV_SYN)
+        {
+            /* the kernel's buffer overflowed, so the state is unknown
+             * until the frame after the drop is complete */
+            if(event->code == SYN_DROPPED)
+                device->syn_dropped = 1;
+            if(event->code != SYN_REPORT)
+                continue;
+            if(device->syn_dropped)
+            {
+                device->syn_dropped = 0;
+                ++device->resyncs;
+                delivered += hidio_core_sync(device, callback, userdata);
+                if(device->sync_pending)
+                    return delivered;
+            }
+            if(device->report_events)
+            {
+                core_event.id = HIDIO_CORE_REPORT;
+                core_event.type = EV_SYN;
+                core_event.code = SYN_REPORT;
+                core_event.value = 0;
+                core_event.timestamp = input_event_time(event);
+                if(!callback(userdata, device, &core_event))
+                    return delivered;
+            }
+            continue;
+        }
+        if(device->syn_dropped)
+            continue;
+        id = hidio_core_find_element(device, event->type, event->code);
+        if(id < 0)
+            continue;
+        device->elements[id].value = event->value;
+        core_event.id = id;
+        core_event.type = event->type;
+        core_event.code = event->code;
+        core_event.value = event->value;
+        core_event.timestamp = input_event_time(event);
+        ++delivered;
+        if(!callback(userdata, device, &core_event))
+            return delivered;
+    }
+}
+
+typedef struct _core_pull
+{
+    t_hidio_core_event *events;
+    int count;
+    int max_events;
+} t_core_pull;
+
+static int core_pull_event(void *userdata, t_hidio_core_device *device,
+                           const t_hidio_core_event *event)
+{
+    t_core_pull *pull = (t_core_pull *)userdata;
+    pull->events[pull->count++] = *event;
+    return pull->count < pull->max_events;
+}
+
+int hidio_core_read_events(t_hidio_core_device *device, t_hidio_core_event *events,
+                           int max_events)
+{
+    t_core_pull pull;
+
+    if(max_events < 1)
+        return 0;
+    pull.events = events;
+    pull.count = 0;
+    pull.max_events = max_events;
+    if(hidio_core_read(device, core_pull_event, &pull) < 0)
+        return -1;
+    return pull.count;
+}
+
+int hidio_core_write(t_hidio_core_device *device, unsigned short type,
+                     unsigned short code, int value)
+{
+    struct input_event events[2];
+
+    memset(events, 0, sizeof(events));
+    events[0].type = type;
+    events[0].code = code;
+    events[0].value = value;
+    events[1].type = EV_SYN;
+    events[1].code = SYN_REPORT;
+    if(write(device->fd, events, sizeof(events)) < 0)
+        return -1;
+    return 0;
+}
+
+/* EVIOCSMASK stops the kernel from queueing the events this file descriptor
+ * doesn't want, so they never cost a read().  EV_SYN is left alone since it
+ * frames the events that do get thru, and these are all the other types
+ * evdev takes a mask for, EV_REP is not one of them. */
+int hidio_core_set_event_mask(t_hidio_core_device *device,
+                              const unsigned char *wanted)
+{
+#ifdef EVIOCSMASK
+    static const struct { unsigned short type; unsigned short count; } mask_types[] = {
+        {EV_KEY, KEY_CNT}, {EV_REL, REL_CNT}, {EV_ABS, ABS_CNT},
+        {EV_MSC, MSC_CNT}, {EV_SW, SW_CNT}, {EV_LED, LED_CNT},
+        {EV_SND, SND_CNT}, {EV_FF, FF_CNT}
+    };
+    unsigned char codes[(KEY_CNT + 7) / 8];
+    struct input_mask mask;
+    t_hidio_core_element *current_element;
+    unsigned int i, j;
+
+    for(i = 0; i < sizeof(mask_types) / sizeof(mask_types[0]); ++i)
+    {
+        memset(codes, wanted ? 0x00 : 0xff, sizeof(codes));
+        for(j = 0; wanted && j < device->num_elements; ++j)
+        {
+            current_element = device->elements + j;
+            if( wanted[j] && (current_element->type == mask_types[i].type) &&
+                (current_element->code < mask_types[i].count) )
+                codes[current_element->code / 8] |= 1 << (current_element->code % 8);
+        }
+        mask.type = mask_types[i].type;
+        mask.codes_size = (mask_types[i].count + 7) / 8;
+        mask.codes_ptr = (__u64)(unsigned long)codes;
+        /* only a kernel without EVIOCSMASK fails them all, any other error
+         * leaves that one type unmasked and the rest still get masked */
+        if( (ioctl(device->fd, EVIOCSMASK, &mask) < 0) &&
+            ((errno == ENOTTY) || (errno == ENOSYS)) )
+            return -1;
+    }
+    return 0;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif /* EVIOCSMASK */
+}
+
+#endif  /* #ifdef __linux__ */
@@ -101,12 +101,12 @@ static void convert_axis_to_symbols(pRecElement pCurrentHIDElement,
 	if (pCurrentHIDElement->relative)
 	{ 
 		new_element->type = ps_relative; 
-		new_element->name = relative_symbols[array_index];
+		new_element->name = hidio_relative_symbol(array_index);
 	}
 	else 
 	{ 
 		new_element->type = ps_absolute; 
-		new_element->name = absolute_symbols[array_index];
+		new_element->name = hidio_absolute_symbol(array_index);
 	}
 }
 
@@ -143,7 +143,7 @@ static void get_usage_symbols(pRecElement pCurrentHIDElement, t_hid_element *new
 		case kHIDUsage_GD_Hatswitch: 
 			// TODO: this is still a mystery how to handle, due to USB HID vs. Linux input.h
 			new_element->type = ps_absolute; 
-			new_element->name = absolute_symbols[9]; /* hatswitch */
+			new_element->name = hidio_absolute_symbol(9); /* hatswitch */
 			break;
 		default:
 			new_element->type = gensym("DESKTOP");
@@ -156,11 +156,11 @@ static void get_usage_symbols(pRecElement pCurrentHIDElement, t_hid_element *new
 		{
 		case kHIDUsage_Sim_Rudder: 
 			new_element->type = ps_absolute;
-			new_element->name = absolute_symbols[5]; /* rz */
+			new_element->name = hidio_absolute_symbol(5); /* rz */
 			break;
 		case kHIDUsage_Sim_Throttle:
 			new_element->type = ps_absolute;
-			new_element->name = absolute_symbols[6]; /* slider */
+			new_element->name = hidio_absolute_symbol(6); /* slider */
 			break;
 		default:
 			new_element->type = gensym("SIMULATION");
@@ -172,21 +172,21 @@ static void get_usage_symbols(pRecElement pCurrentHIDElement, t_hid_element *new
 		new_element->type = ps_key;
 		if( (pCurrentHIDElement->usage > -1) && 
 			(pCurrentHIDElement->usage < KEY_ARRAY_MAX) )
-			new_element->name = key_symbols[pCurrentHIDElement->usage];
+			new_element->name = hidio_key_symbol(pCurrentHIDElement->usage);
 		else /* PowerBook ADB keyboard reports 0xffffffff */
-			new_element->name = key_symbols[0];
+			new_element->name = hidio_key_symbol(0);
 		break;
 	case kHIDPage_Button:
 		new_element->type = ps_button;
-		new_element->name = button_symbols[pCurrentHIDElement->usage];
+		new_element->name = hidio_button_symbol(pCurrentHIDElement->usage);
 		break;
 	case kHIDPage_LEDs:
 		new_element->type = ps_led; 
-		new_element->name = led_symbols[pCurrentHIDElement->usage];
+		new_element->name = hidio_led_symbol(pCurrentHIDElement->usage);
 		break;
 	case kHIDPage_PID:
 		new_element->type = ps_pid; 
-		new_element->name = pid_symbols[pCurrentHIDElement->usage];
+		new_element->name = hidio_pid_symbol(pCurrentHIDElement->usage);
 		break;
 	default:
 		/* the rest are "vendor defined" so no translation table is possible */
@@ -197,25 +197,6 @@ static void get_usage_symbols(pRecElement pCurrentHIDElement, t_hid_element *new
 	}
 }
 
-/* this functions checks to see if there are any existing instances of a given
- * type/code and assigns an number to this instance */
-static t_float get_type_name_instance(t_symbol *type, t_symbol *name, 
-									   int argc, t_hid_element **argv) 
-{
-	int i;
-	int instance_count = 0;
-	for(i=0; i<argc; ++i)
-	{
-		if( (argv[i]->name == name) && (argv[i]->type == type) )
-		{
-			++instance_count;
-//			post("found %d instances of %s %s", instance_count, type->s_name, name->s_name);
-		}
-	}
-	return((t_float) instance_count);
-}
-
-
 /*
  * Linux input events report hatswitches as absolute axes with -1, 0, 1 as
  * possible values.  MacOS X HID Manager reports hatswitches as a specific
@@ -396,7 +377,8 @@ static void hidio_build_element_list(t_hidio *x)
 	pRecDevice pCurrentHIDDevice = device_pointer[x->x_device_number];
 	t_hid_element *new_element;
 
-	element_count[x->x_device_number] = 0;
+	hidio_element_count[x->x_device_number] = 0;
+	hidio_clear_element_values(x->x_device_number);
 	if( HIDIsValidDevice(pCurrentHIDDevice) ) 
 	{
 		/* queuing one element at a time only works for the first element, so
@@ -427,10 +409,7 @@ static void hidio_build_element_list(t_hidio *x)
 			atom_setlong(new_element->output_message + 1, (long)new_element->instance);
 #endif /* PD */
 			new_element->relative = pCurrentHIDElement->relative;
-			new_element->instance = get_type_name_instance(new_element->type, 
-														   new_element->name,
-														   element_count[x->x_device_number],
-														   element[x->x_device_number]);
+			/* instance is numbered by hidio_number_instances() once the list is done */
 			
 			if(!pCurrentHIDElement->relative) /* relative elements should remain queued */
 			{
@@ -471,10 +450,15 @@ static void hidio_build_element_list(t_hidio *x)
 			}
 			new_element->min = pCurrentHIDElement->min;
 			new_element->max = pCurrentHIDElement->max;
+			/* start from the real positions of faders, switches, etc. */
+			if(!new_element->relative)
+				hidio_element_values[x->x_device_number][hidio_element_count[x->x_device_number]] = 
+					hidio_element_previous[x->x_device_number][hidio_element_count[x->x_device_number]] = 
+					HIDGetElementValue(pCurrentHIDDevice, pCurrentHIDElement);
 			debug_post(LOG_DEBUG,"\tlogical min %d max %d",
 						pCurrentHIDElement->min,pCurrentHIDElement->max);
-			element[x->x_device_number][element_count[x->x_device_number]] = new_element;
-			++element_count[x->x_device_number];
+			hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
+			++hidio_element_count[x->x_device_number];
 			pCurrentHIDElement = HIDGetNextDeviceElement(pCurrentHIDElement, kHIDElementTypeIO);
 		}
 	}
@@ -491,6 +475,8 @@ void hidio_elements(t_hidio *x)
 	char type_name[256];
 	char usage_name[256];
 
+	if( (x->x_device_number < 0) || (x->x_device_number >= MAX_DEVICES) )
+		return; /* not a device of this process, e.g. -shm */
 	pCurrentHIDDevice = device_pointer[x->x_device_number];
 	if ( ! HIDIsValidDevice(pCurrentHIDDevice) )
 	{
@@ -498,13 +484,13 @@ void hidio_elements(t_hidio *x)
 		return;
 	}
     post("__________________________________________________");
-	post("[hidio] found %d elements in '%s' '%s' (device #%d)", element_count[x->x_device_number],
+	post("[hidio] found %d elements in '%s' '%s' (device #%d)", hidio_element_count[x->x_device_number],
          pCurrentHIDDevice->manufacturer, pCurrentHIDDevice->product, x->x_device_number);
 	post("\n TYPE\t\tCODE\t#\tcookie\tEVENT NAME");
 	post("-----------------------------------------------------------");
-	for(i=0; i<element_count[x->x_device_number]; i++)
+	for(i=0; i<hidio_element_count[x->x_device_number]; i++)
 	{
-		current_element = element[x->x_device_number][i];
+		current_element = hidio_element_table[x->x_device_number][i];
 		pCurrentHIDElement = (pRecElement) current_element->pHIDElement;
 		HIDGetTypeName((IOHIDElementType) pCurrentHIDElement->type, type_name);
 		HIDGetUsageName(pCurrentHIDElement->usagePage, 
@@ -591,7 +577,7 @@ void hidio_platform_specific_info(t_hidio *x)
 	t_symbol *output_symbol;
 	t_atom *output_atom = (t_atom *)getbytes(sizeof(t_atom));
 
-	if(x->x_device_number > -1)
+	if( (x->x_device_number > -1) && (x->x_device_number < MAX_DEVICES) )
 	{
 //		pCurrentHIDDevice = hidio_get_device_by_number(x->x_device_number);
 		pCurrentHIDDevice = device_pointer[x->x_device_number];
@@ -665,22 +651,23 @@ void hidio_get_events(t_hidio *x)
 	pCurrentHIDDevice = device_pointer[x->x_device_number];
 
 	/* get the queued events first and store them */
-// TODO: while( (HIDGetEvent(pCurrentHIDDevice, (void*) &event)) && (event_counter < MAX_EVENTS_PER_POLL) ) 
-	while(HIDGetEvent(pCurrentHIDDevice, (void*) &event))
+	while( hidio_events_wanted(x) && HIDGetEvent(pCurrentHIDDevice, (void*) &event) )
 	{
 		i=0;
 		do {
-			current_element = element[x->x_device_number][i];
+			current_element = hidio_element_table[x->x_device_number][i];
 			++i;
-		} while( (i < element_count[x->x_device_number]) && 
+		} while( (i < hidio_element_count[x->x_device_number]) && 
 				 (((pRecElement)current_element->pHIDElement)->cookie != 
 				  (IOHIDElementCookie) event.elementCookie) );
 		
-		current_element->value = event.value;
+		timestamp =  * (uint64_t *) &(event.timestamp);	
+		/* calculate_event_latency() is in microseconds, the stats are in ms */
+		hidio_element_update(x, current_element, event.value,
+							 calculate_event_latency(timestamp, 0) * 0.001);
 //		debug_post(LOG_DEBUG,"output this: %s %s %d prev %d",current_element->type->s_name,
 //			 current_element->name->s_name, current_element->value, 
 //			 current_element->previous_value);
-		timestamp =  * (uint64_t *) &(event.timestamp);	
 /*
 // temp hack for measuring latency
         difference = calculate_event_latency(timestamp,0);
@@ -706,14 +693,16 @@ void hidio_get_events(t_hidio *x)
 */
 	}
 	/* absolute axes don't need to be queued, they can just be polled */
-	for(i=0; i< element_count[x->x_device_number]; ++i)
+	for(i=0; i< hidio_element_count[x->x_device_number]; ++i)
 	{
-		current_element = element[x->x_device_number][i];
+		current_element = hidio_element_table[x->x_device_number][i];
 		if(current_element->polled) 
 		{
-			current_element->value = 
-				HIDGetElementValue(pCurrentHIDDevice, 
-								   (pRecElement)current_element->pHIDElement);
+			SInt32 value = HIDGetElementValue(pCurrentHIDDevice, 
+											  (pRecElement)current_element->pHIDElement);
+			if(value != ELEMENT_VALUE(current_element))
+				hidio_element_update(x, current_element, value,
+									 hidio_get_system_time());
 		}
 	}
 }
@@ -735,24 +724,19 @@ void hidio_write_event_symbol_int(t_hidio *x, t_symbol *type, t_int code,
 void hidio_write_event_symbols(t_hidio *x, t_symbol *type, t_symbol *name, 
                               t_int instance, t_int value)
 {
-    /* TODO handle multiple instances of the same usage, i.e. arrays */
 	debug_post(LOG_DEBUG,"hidio_write_event_symbols");
-    int i;
     t_hid_element *current_element;
 	IOHIDEventStruct event;
     pRecDevice  pCurrentHIDDevice = device_pointer[x->x_device_number];
     pRecElement pCurrentHIDElement;
-    for(i=0; i<element_count[x->x_device_number]; i++)
+    current_element = hidio_find_element(x->x_device_number, type, name, instance);
+    if(current_element == NULL)
     {
-        current_element = element[x->x_device_number][i];
-        if((current_element->type == type) 
-           && (current_element->name == name)
-           && (current_element->instance == instance))
-        {
-            pCurrentHIDElement = current_element->pHIDElement;
-            break;
-        }
+        pd_error(x, "[hidio] write: no element %s %s %d", 
+                 type->s_name, name->s_name, (int)instance);
+        return;
     }
+    pCurrentHIDElement = current_element->pHIDElement;
     post("element usage page and usage: 0x%04x 0x%04x", pCurrentHIDElement->usagePage, pCurrentHIDElement->usage);
 	event.elementCookie = (IOHIDElementCookie)pCurrentHIDElement->cookie;
 	event.value = (SInt32)value;
@@ -862,10 +846,82 @@ void hidio_build_device_list(void)
 			device_pointer[device_number] = pCurrentHIDDevice;
 		pCurrentHIDDevice = HIDGetNextDevice(pCurrentHIDDevice);
 	}
-	device_count = (unsigned int) HIDCountDevices(); // set the global variable
+	hidio_device_count = (unsigned int) HIDCountDevices(); // set the global variable
 	debug_post(LOG_WARNING,"[hidio] completed device list.");
 }
 
+void hidio_print(t_hidio *x)
+{
+	hidio_devices(x);
+	if (x->x_device_open) hidio_elements(x);
+}
+
+/* HID Utilities has no way to filter the queue, so unsubscribed elements
+ * are dropped in hidio_element_update() */
+void hidio_set_event_mask(t_hidio *x)
+{
+	debug_post(LOG_DEBUG,"hidio_set_event_mask");
+}
+
+/* [open-all( and [open-composite( are only implemented on GNU/Linux, there
+ * is no single call to wait on several HID Utilities queues yet */
+t_int hidio_open_multi(t_hidio *x)
+{
+	pd_error(x,"[hidio] open-all and open-composite are not supported on this platform");
+	return 0;
+}
+
+void hidio_close_multi(t_hidio *x)
+{
+}
+
+int hidio_get_ready_multi(t_hidio *x, unsigned char *ready)
+{
+	return 0;
+}
+
+void hidio_select_multi(t_hidio *x, int index)
+{
+}
+
+/* each device is opened on its own here, so a device has no siblings */
+t_int hidio_get_siblings(short device_number, short *siblings)
+{
+	siblings[0] = device_number;
+	return 1;
+}
+
+/* there is no worker thread here yet, [async 1( opens and refreshes right
+ * away like before */
+t_int hidio_async_open(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+t_int hidio_async_refresh(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+t_int hidio_async_done(t_hidio *x)
+{
+	return 1;
+}
+
+t_int hidio_async_finish(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+void hidio_async_discard(t_hidio *x)
+{
+}
+
+/* tablets are only read as frames on GNU/Linux, nothing is framed here */
+void hidio_output_frame(t_hidio *x)
+{
+}
+
 void hidio_platform_specific_free(t_hidio *x)
 {
 	int j;
@@ -4,10 +4,13 @@
 
 #include <linux/input.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 
 #include <sys/stat.h>
 #include <string.h>
+#include <errno.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/fcntl.h>
 #include <unistd.h>
@@ -27,6 +30,11 @@
 
 #define LINUX_BLOCK_DEVICE   "/dev/input/event"
 
+/* the t_hid_element of a device has the same index as its libhidio_core id */
+#if HIDIO_CORE_MAX_ELEMENTS > MAX_ELEMENTS
+#error "MAX_ELEMENTS has to hold all the elements of a libhidio_core device"
+#endif
+
 
 /*------------------------------------------------------------------------------
  * from evtest.c from the ff-utils package
@@ -55,25 +63,47 @@
 
 t_symbol* hidio_convert_linux_buttons_to_numbers(__u16 linux_code)
 {
-    char hidio_code[MAXPDSTRING] = "\0";
     if(linux_code >= 0x100) 
 	{
 	    if(linux_code < BTN_MOUSE)         /* numbered buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_MISC);  
+            return hidio_button_symbol(linux_code - BTN_MISC);
 	    else if(linux_code < BTN_JOYSTICK) /* mouse buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_MOUSE);
+            return hidio_button_symbol(linux_code - BTN_MOUSE);
 	    else if(linux_code < BTN_GAMEPAD)  /* joystick buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_JOYSTICK);
+            return hidio_button_symbol(linux_code - BTN_JOYSTICK);
 	    else if(linux_code < BTN_DIGI)     /* gamepad buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_GAMEPAD);
+            return hidio_button_symbol(linux_code - BTN_GAMEPAD);
 	    else if(linux_code < BTN_WHEEL)    /* tablet buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_DIGI);
+            return hidio_button_symbol(linux_code - BTN_DIGI);
 	    else if(linux_code < KEY_OK)       /* wheel buttons */
-            snprintf(hidio_code, MAXPDSTRING,"button_%d",linux_code - BTN_WHEEL);
-	    else 
-            return gensym("?");
+            return hidio_button_symbol(linux_code - BTN_WHEEL);
 	}
-    return gensym(hidio_code);
+    return gensym("?");
+}
+
+/* the names from input_arrays.c, the gaps in there are filled in here so
+ * that only the names of elements that exist end up as symbols */
+static char *linux_type_name(unsigned short type, char *buffer, size_t size)
+{
+    if( (type < EV_CNT) && ev[type] )
+        return ev[type];
+    snprintf(buffer, size, "ev_%d", type);
+    return buffer;
+}
+
+static char *linux_code_name(unsigned short type, unsigned short code, 
+                             char *buffer, size_t size)
+{
+    if(type >= EV_CNT)
+        snprintf(buffer, size, "ev_%d_%d", type, code + 1);
+    else if( event_names[type] && (code < event_names_total[type]) && 
+             event_names[type][code] )
+        return event_names[type][code];
+    else if(event_prefixes[type])
+        snprintf(buffer, size, "%s_%d", event_prefixes[type], code);
+    else
+        snprintf(buffer, size, "ev_%d_%d", type, code + 1);
+    return buffer;
 }
 
 
@@ -84,14 +114,17 @@ void hidio_elements(t_hidio *x)
     //    char event_type_string[256];
     //    char event_code_string[256];
     char *event_type_name = "";
+    char type_buffer[MAXPDSTRING], code_buffer[MAXPDSTRING];
     t_int i, j;
     /* counts for various event types */
     t_int syn_count,key_count,rel_count,abs_count,msc_count,led_count,
 	snd_count,rep_count,ff_count,pwr_count,ff_status_count;
 
+    if(x->x_core == NULL) return;
+
     /* get bitmask representing supported element (axes, keys, etc.) */
     memset(element_bitmask, 0, sizeof(element_bitmask));
-    ioctl(x->x_fd, EVIOCGBIT(0, EV_MAX), element_bitmask[0]);
+    ioctl(x->x_core->fd, EVIOCGBIT(0, EV_MAX), element_bitmask[0]);
     post("\nSupported events:");
     
     /* init all count vars */
@@ -123,7 +156,7 @@ void hidio_elements(t_hidio *x)
 			}
 		 
 		    /* get bitmask representing supported button types */
-		    ioctl(x->x_fd, EVIOCGBIT(i, KEY_MAX), element_bitmask[i]);
+		    ioctl(x->x_core->fd, EVIOCGBIT(i, KEY_MAX), element_bitmask[i]);
 		 
 		    post("");
 		    post("  TYPE\tCODE\tEVENT NAME");
@@ -143,17 +176,17 @@ void hidio_elements(t_hidio *x)
 					    if(hidio_codesym)
 						{
 						    post("  %s\t%s\t%s (%s)",
-							 ev[i] ? ev[i] : "?", 
+							 linux_type_name(i, type_buffer, MAXPDSTRING), 
 							 hidio_codesym->s_name,
 							 event_type_name,
-							 event_names[i] ? (event_names[i][j] ? event_names[i][j] : "?") : "?");
+							 linux_code_name(i, j, code_buffer, MAXPDSTRING));
 						}
 					}
 				    else if(i != EV_SYN)
 					{
 					    post("  %s\t%s\t%s",
-						 ev[i] ? ev[i] : "?", 
-						 event_names[i][j] ? event_names[i][j] : "?", 
+						 linux_type_name(i, type_buffer, MAXPDSTRING), 
+						 linux_code_name(i, j, code_buffer, MAXPDSTRING), 
 						 event_type_name);
                         
 					    /* 	  post("    Event code %d (%s)", j, names[i] ? (names[i][j] ? names[i][j] : "?") : "?"); */
@@ -235,142 +268,312 @@ void hidio_devices(t_hidio *x)
 
 
 
+/* libhidio_core has already enumerated the device, this makes a
+ * t_hid_element for each of its elements, at the index of the core's id */
 static void hidio_build_element_list(t_hidio *x) 
 {
     debug_post(LOG_DEBUG,"hidio_build_element_list");
-    unsigned long element_bitmask[EV_MAX][NBITS(KEY_MAX)];
-    uint8_t abs_bitmask[ABS_MAX/8 + 1];
-    struct input_absinfo abs_features;
+    t_hidio_core_element *core_element;
     t_hid_element *new_element = NULL;
-    t_int i, j;
+    char type_buffer[MAXPDSTRING], code_buffer[MAXPDSTRING];
+    unsigned int i;
   
-    if( x->x_fd < 0 ) 
+    if( x->x_core == NULL ) 
         return;
 
-    element_count[x->x_device_number] = 0;
+    hidio_element_count[x->x_device_number] = 0;
+    hidio_clear_element_values(x->x_device_number);
 
-    /* get bitmask representing supported elements (axes, keys, etc.) */
-    memset(element_bitmask, 0, sizeof(element_bitmask));
-    if( ioctl(x->x_fd, EVIOCGBIT(0, EV_MAX), element_bitmask[0]) < 0 )
-        perror("[hidio] error: evdev ioctl: element_bitmask");
-    memset(abs_bitmask, 0, sizeof(abs_bitmask));
-    if( ioctl(x->x_fd, EVIOCGBIT(EV_ABS, sizeof(abs_bitmask)), abs_bitmask) < 0 ) 
-        perror("[hidio] error: evdev ioctl: abs_bitmask");
-    for( i = 1; i < EV_MAX; i++ ) 
+    for( i = 0; i < x->x_core->num_elements; i++ ) 
     {
-        if(test_bit(i, element_bitmask[0])) 
+        core_element = x->x_core->elements + i;
+        new_element = getbytes(sizeof(t_hid_element));
+        new_element->min = core_element->min;
+        new_element->max = core_element->max;
+        new_element->linux_type = core_element->type; /* the int from linux/input.h */
+        new_element->type = gensym(linux_type_name(core_element->type, type_buffer, 
+                                                   MAXPDSTRING)); /* the symbol */
+        new_element->linux_code = core_element->code;
+        if((core_element->type == EV_KEY) && (core_element->code >= BTN_MISC) && 
+           (core_element->code < KEY_OK) )
         {
-            /* get bitmask representing supported elements */
-            ioctl(x->x_fd, EVIOCGBIT(i, KEY_MAX), element_bitmask[i]);
-            /* cycle through all possible event codes (axes, keys, etc.) 
-             * testing to see which are supported.
-             */
-            for(j = 0; j < KEY_MAX; j++) 
-            {
-                if(test_bit(j, element_bitmask[i])) 
-                {
-                    new_element = getbytes(sizeof(t_hid_element));
-                    if( (i == EV_ABS) && (j < ABS_MAX) && (test_bit(j, abs_bitmask)) )
-                    {
-                        if(ioctl(x->x_fd, EVIOCGABS(j), &abs_features) < 0) 
-                        {
-                            post("[hidio]: EVIOCGABS ioctl error for element: 0x%03x", j, j);
-                            perror("[hidio]: EVIOCGABS ioctl error:");
-                        }
-                        new_element->min = abs_features.minimum;
-                        new_element->max = abs_features.maximum;
-                    }
-                    else
-                    {
-                        new_element->min = 0;
-                        new_element->max = 0;
-                    }
-                    new_element->linux_type = i; /* the int from linux/input.h */
-                    new_element->type = gensym(ev[i] ? ev[i] : "?"); /* the symbol */
-                    new_element->linux_code = j;
-                    if((i == EV_KEY) && (j >= BTN_MISC) && (j < KEY_OK) )
-                    {
-                        new_element->type = ps_button;
-                        new_element->name = hidio_convert_linux_buttons_to_numbers(j);
-                    }
-                    else
-                    {
-                        new_element->name = gensym(event_names[i][j] ? event_names[i][j] : "?");
-                    }
-                    if( i == EV_REL )
-                        new_element->relative = 1;
-                    else
-                        new_element->relative = 0;
-                    SETSYMBOL(new_element->output_message, new_element->name);
-                    SETFLOAT(new_element->output_message + 1, new_element->instance);
-                    // fill in the t_hid_element struct here
-                    post("x->x_device_number: %d   element_count[]: %d",
-                         x->x_device_number, element_count[x->x_device_number]);
-                    post("linux_type/linux_code: %d/%d  type/name: %s/%s    max: %d   min: %d ",
-                         new_element->linux_type, new_element->linux_code,
-                         new_element->type->s_name, new_element->name->s_name,
-                         new_element->max, new_element->min);
-                    post("\tpolled: %d   relative: %d",
-                         new_element->polled, new_element->relative);
-                    element[x->x_device_number][element_count[x->x_device_number]] = new_element;
-                    ++element_count[x->x_device_number];
-                }
-            }
-        }        
+            new_element->type = ps_button;
+            new_element->name = hidio_convert_linux_buttons_to_numbers(core_element->code);
+        }
+        else
+        {
+            new_element->name = gensym(linux_code_name(core_element->type, core_element->code, 
+                                                       code_buffer, MAXPDSTRING));
+        }
+        if( core_element->type == EV_REL )
+            new_element->relative = 1;
+        else
+            new_element->relative = 0;
+        /* the core read the state when opening, so start from the real
+         * positions of faders, switches, etc. as if already output */
+        hidio_element_values[x->x_device_number][i] = 
+            hidio_element_previous[x->x_device_number][i] = core_element->value;
+        SETSYMBOL(new_element->output_message, new_element->name);
+        SETFLOAT(new_element->output_message + 1, new_element->instance);
+        // fill in the t_hid_element struct here
+        post("x->x_device_number: %d   hidio_element_count[]: %d",
+             x->x_device_number, hidio_element_count[x->x_device_number]);
+        post("linux_type/linux_code: %d/%d  type/name: %s/%s    max: %d   min: %d ",
+             new_element->linux_type, new_element->linux_code,
+             new_element->type->s_name, new_element->name->s_name,
+             new_element->max, new_element->min);
+        post("\tpolled: %d   relative: %d",
+             new_element->polled, new_element->relative);
+        hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
+        ++hidio_element_count[x->x_device_number];
     }
 }
 
+/* find the element matching a Linux event type/code, NULL if there is none */
+static t_hid_element *find_element_by_type_code(t_hidio *x, __u16 linux_type, 
+                                                __u16 linux_code)
+{
+    int id;
+
+    if(x->x_core == NULL) return NULL;
+    id = hidio_core_find_element(x->x_core, linux_type, linux_code);
+    if(id < 0) return NULL;
+    debug_post(9,"id: %d  linux_type: %d  linux_code: %d", id, linux_type, linux_code);
+    return hidio_element_table[x->x_device_number][id];
+}
+
 /* ------------------------------------------------------------------------------ */
 /* Pd [hidio] FUNCTIONS */
 /* ------------------------------------------------------------------------------ */
 
+/* ------------------------------------------------------------------------------ */
+/* TABLETS */
+/* ------------------------------------------------------------------------------ */
+
+/* A tablet sends each position of the pen as a burst of axis events closed
+ * by a SYN_REPORT, 200 times a second or more, and the BTN_TOOL_* keys say
+ * which tool is in proximity.  The pen elements are framed, so instead of
+ * one message per axis, hidio_tick() outputs them together as
+ * [stylus pen x y pressure tilt_x tilt_y distance(, and [proximity pen 1( or
+ * 0 when a tool comes or goes.  Each report is held back until its
+ * SYN_REPORT and then stored thru hidio_element_update() like any other
+ * events.  When the tool leaves, the driver zeroes the axes in the same
+ * report, those are dropped so that the patch keeps the last real position. */
+
+static unsigned short tablet_axis_codes[TABLET_AXES] = {
+    ABS_X, ABS_Y, ABS_PRESSURE, ABS_TILT_X, ABS_TILT_Y, ABS_DISTANCE
+};
+
+/* BTN_TOOL_PEN to BTN_TOOL_LENS */
+static char *tablet_tool_names[TABLET_TOOLS] = {
+    "pen", "rubber", "brush", "pencil", "airbrush", "finger", "mouse", "lens"
+};
+
+static void linux_tablet_setup(t_hidio *x)
+{
+    t_hidio_tablet *tablet = &x->x_pen;
+    t_hid_element **elements = hidio_element_table[x->x_device_number];
+    int k;
+
+    memset(tablet, 0, sizeof(t_hidio_tablet));
+    /* [open-all( reads several devices thru one callback, so only one */
+    if( (x->x_multi_count > 0) || 
+        (hidio_core_find_element(x->x_core, EV_KEY, BTN_TOOL_PEN) < 0) )
+        return;
+    tablet->has_pen = 1;
+    for(k = 0; k < TABLET_AXES; ++k)
+    {
+        tablet->axis_ids[k] = hidio_core_find_element(x->x_core, EV_ABS, 
+                                                      tablet_axis_codes[k]);
+        if(tablet->axis_ids[k] >= 0)
+            elements[tablet->axis_ids[k]]->framed = 1;
+    }
+    for(k = 0; k < TABLET_TOOLS; ++k)
+    {
+        tablet->tool_ids[k] = hidio_core_find_element(x->x_core, EV_KEY, 
+                                                      BTN_TOOL_PEN + k);
+        if(tablet->tool_ids[k] >= 0)
+            elements[tablet->tool_ids[k]]->framed = 1;
+        tablet->tool_symbols[k] = gensym(tablet_tool_names[k]);
+    }
+    tablet->stylus_symbol = gensym("stylus");
+    tablet->proximity_symbol = gensym("proximity");
+    x->x_core->report_events = 1;
+    debug_post(LOG_INFO,"[hidio] tablet, outputting [stylus( frames, [tablet 0( turns them off");
+}
+
+static void linux_tablet_proximity(t_hidio *x, t_symbol *tool, t_float in)
+{
+    t_atom proximity[2];
+
+    SETSYMBOL(proximity, tool);
+    SETFLOAT(proximity + 1, in);
+    outlet_anything(x->x_data_outlet, x->x_pen.proximity_symbol, 2, proximity);
+}
+
+void hidio_output_frame(t_hidio *x)
+{
+    t_hidio_tablet *tablet = &x->x_pen;
+    t_atom frame[TABLET_AXES + 1];
+    int k, id;
+
+    if(tablet->frame_tool == tablet->tool)
+    {
+        if(tablet->tool == NULL)
+            return;
+    }
+    else
+    {
+        if(tablet->frame_tool)
+            linux_tablet_proximity(x, tablet->frame_tool, 0);
+        if(tablet->tool)
+            linux_tablet_proximity(x, tablet->tool, 1);
+        tablet->frame_tool = tablet->tool;
+        if(tablet->tool == NULL)
+            return;
+    }
+    SETSYMBOL(frame, tablet->tool);
+    for(k = 0; k < TABLET_AXES; ++k)
+    {
+        id = tablet->axis_ids[k];
+        SETFLOAT(frame + k + 1, (id < 0) ? 0 : 
+                 hidio_output_value(hidio_element_table[x->x_device_number][id]));
+    }
+    outlet_anything(x->x_data_outlet, tablet->stylus_symbol, TABLET_AXES + 1, frame);
+}
+
+/* the end of a report: store the tools, then the axes if a tool is still in
+ * proximity, otherwise forget them */
+static void linux_tablet_report(t_hidio *x, double timestamp)
+{
+    t_hidio_tablet *tablet = &x->x_pen;
+    t_hid_element **elements = hidio_element_table[x->x_device_number];
+    unsigned char down;
+    int k;
+
+    for(k = 0; k < TABLET_TOOLS; ++k)
+    {
+        if( !(tablet->tools_received & (1 << k)) )
+            continue;
+        down = (tablet->tools_down >> k) & 1;
+        if(down)
+            tablet->tool = tablet->tool_symbols[k];
+        else if(tablet->tool == tablet->tool_symbols[k])
+            tablet->tool = NULL;
+        hidio_element_update(x, elements[tablet->tool_ids[k]], down, timestamp);
+    }
+    for(k = 0; k < TABLET_AXES; ++k)
+    {
+        if(tablet->tool && tablet->received[k])
+            hidio_element_update(x, elements[tablet->axis_ids[k]], 
+                                 tablet->frame[k], timestamp);
+        tablet->received[k] = 0;
+    }
+    tablet->tools_received = 0;
+}
+
+/* returns 1 if the event belongs to the pen and was handled here */
+static int linux_tablet_event(t_hidio *x, const t_hidio_core_event *event)
+{
+    t_hidio_tablet *tablet = &x->x_pen;
+    int k;
+
+    if(event->id == HIDIO_CORE_REPORT)
+    {
+        linux_tablet_report(x, event->timestamp);
+        return 1;
+    }
+    if( (event->type == EV_KEY) && (event->code >= BTN_TOOL_PEN) &&
+        (event->code <= BTN_TOOL_LENS) )
+    {
+        k = event->code - BTN_TOOL_PEN;
+        tablet->tools_received |= 1 << k;
+        if(event->value)
+            tablet->tools_down |= 1 << k;
+        else
+            tablet->tools_down &= ~(1 << k);
+        return 1;
+    }
+    if(event->type != EV_ABS)
+        return 0;
+    for(k = 0; k < TABLET_AXES; ++k)
+    {
+        if(event->code == tablet_axis_codes[k])
+        {
+            tablet->frame[k] = event->value;
+            tablet->received[k] = 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* libhidio_core calls this for each event, including the elements that
+ * changed while the kernel was dropping events.  Returning 0 leaves the rest
+ * of the events queued in the core until the next tick. */
+static int linux_core_event(void *userdata, t_hidio_core_device *device,
+                            const t_hidio_core_event *event)
+{
+    t_hidio *x = (t_hidio *)userdata;
+
+    if(x->x_pen.has_pen && x->x_tablet && linux_tablet_event(x, event))
+        return hidio_events_wanted(x);
+    if(event->id == HIDIO_CORE_REPORT)
+        return 1;
+    hidio_element_update(x, hidio_element_table[x->x_device_number][event->id], 
+                         event->value, event->timestamp);
+    debug_post(9,"value to output: %d",event->value);
+    return hidio_events_wanted(x);
+}
+
+
 void hidio_get_events(t_hidio *x)
 {
     debug_post(9,"hidio_get_events");
 
-    /* for debugging, counts how many events are processed each time hidio_read() is called */
-    DEBUG(t_int event_counter = 0;);
-    unsigned short i;
-    t_hid_element *output_element = NULL;
+    t_hidio_stats *stats = hidio_stats + x->x_device_number;
+    unsigned long read_calls, resyncs;
 
-    /* this will go into the generic read function declared in hidio.h and
-     * implemented in hidio_linux.c 
-     */
-    struct input_event hidio_input_event;
+    if(x->x_core == NULL) return;
+    if(!hidio_events_wanted(x)) return;
 
-    if(x->x_fd < 0) return;
+    read_calls = x->x_core->read_calls;
+    resyncs = x->x_core->resyncs;
+    if(hidio_core_read(x->x_core, linux_core_event, x) < 0)
+        debug_post(LOG_WARNING,"[hidio] read failed: %s", strerror(errno));
+    stats->read_calls += x->x_core->read_calls - read_calls;
+    stats->resyncs += x->x_core->resyncs - resyncs;
+}
 
-    while( read (x->x_fd, &(hidio_input_event), sizeof(struct input_event)) > -1 )
-	{
-	    if( hidio_input_event.type != EV_SYN )
-		{
-		    for( i=0; i < element_count[x->x_device_number]; ++i )
-			{
-			    output_element = element[x->x_device_number][i];
-			    if( (hidio_input_event.code == output_element->linux_code) && \
-                    (hidio_input_event.type == output_element->linux_type) )
-				{
-				    output_element->value = hidio_input_event.value;
-				    debug_post(9,"i: %d  linux_type: %d  linux_code: %d", i, 
-					       output_element->linux_type, output_element->linux_code);
-				    debug_post(9,"value to output: %d",output_element->value);
-				    break;
-				}
-			}
-		    if( output_element != NULL )
-			hidio_output_event(x, output_element);
-		}
-	    DEBUG(++event_counter;);
-	}
-    DEBUG(
-	if(event_counter > 0)
-	debug_post(8,"output %d events",event_counter);
-	);
-	
-    return;
+
+/* EVIOCSMASK (since Linux 4.4) stops the kernel from queueing events this
+ * file descriptor doesn't want, so they never cost a read(). */
+void hidio_set_event_mask(t_hidio *x)
+{
+    unsigned char wanted[MAX_ELEMENTS];
+    short device_number = x->x_device_number;
+    unsigned int i;
+
+    if( (x->x_core == NULL) || (device_number < 0) ) return;
+    /* no subscriptions means everything gets thru */
+    for(i = 0; hidio_subscribed_count[device_number] && i < hidio_element_count[device_number]; ++i)
+        wanted[i] = hidio_element_table[device_number][i]->subscribed;
+    if(hidio_core_set_event_mask(x->x_core, 
+                                 hidio_subscribed_count[device_number] ? wanted : NULL) < 0)
+        /* older kernel, hidio_element_update() filters instead */
+        debug_post(LOG_INFO, "[hidio] EVIOCSMASK: %s", strerror(errno));
 }
 
 
+/* send one event to the device followed by a SYN_REPORT, e.g. to set LEDs */
+static void write_input_event(t_hidio *x, __u16 linux_type, __u16 linux_code,
+                              t_int value)
+{
+    if(x->x_core == NULL) return;
+    if(hidio_core_write(x->x_core, linux_type, linux_code, value) < 0)
+        pd_error(x, "[hidio] write failed: %s", strerror(errno));
+}
+
 void hidio_write_packet(void)
 {
 	debug_post(LOG_DEBUG,"hidio_write_packet");
@@ -387,24 +590,43 @@ void hidio_write_event_symbols(t_hidio *x, t_symbol *type, t_symbol *code,
                               t_int instance, t_int value)
 {
 	debug_post(LOG_DEBUG,"hidio_write_event_symbols");
+	t_hid_element *output_element = hidio_find_element(x->x_device_number, 
+	                                                   type, code, instance);
+	if(output_element == NULL)
+	    pd_error(x, "[hidio] write: no element %s %s %d", 
+	             type->s_name, code->s_name, (int)instance);
+	else
+	    write_input_event(x, output_element->linux_type, 
+	                      output_element->linux_code, value);
 }
 
 void hidio_write_event_ints(t_hidio *x, t_int type, t_int code, 
                               t_int instance, t_int value)
 {
 	debug_post(LOG_DEBUG,"hidio_write_event_ints");
+	/* the type and code are the raw GNU/Linux numbers, instance is unused */
+	write_input_event(x, (__u16)type, (__u16)code, value);
 }
 
 
+/* everything after hidio_core_open(), once x_core and x_device_number are set */
+static t_int linux_setup_device(t_hidio *x)
+{
+    post ("[hidio] opened device %d (%s%d): %s",
+	  x->x_device_number,LINUX_BLOCK_DEVICE,x->x_device_number,x->x_core->name);
+
+    post("pre hidio_build_element_list");
+    hidio_build_element_list(x);
+    linux_tablet_setup(x);
+
+    return EXIT_SUCCESS;
+}
+
 t_int hidio_open_device(t_hidio *x, short device_number)
 {
     debug_post(LOG_DEBUG,"hidio_open_device");
 
-    char device_name[MAXPDSTRING] = "Unknown";
-    char block_device[FILENAME_MAX] = "/dev/input/event0";
-    struct input_event hidio_input_event;
-
-    x->x_fd = -1;
+    x->x_core = NULL;
     
     if(device_number < 0) 
     {
@@ -413,50 +635,55 @@ t_int hidio_open_device(t_hidio *x, short device_number)
     }
         
     x->x_device_number = device_number;
-    snprintf(block_device, FILENAME_MAX, "/dev/input/event%d", x->x_device_number);
-
-    if(*block_device) 
-	{
-	    /* open the device read-only, non-exclusive */
-	    //        x->x_fd = open(block_device, O_RDONLY | O_NONBLOCK);
-	    x->x_fd = open(block_device, O_RDWR | O_NONBLOCK);
-	    /* test if device open */
-	    if(x->x_fd < 0 ) 
-		{ 
-		    error("[hidio] open %s failed",block_device);
-		    x->x_fd = -1;
-		    return EXIT_FAILURE;
-		}
-	} 
-  
-    /* read input_events from the HID_DEVICE stream 
-     * It seems that is just there to flush the input event queue
-     */
-    while (read (x->x_fd, &(hidio_input_event), sizeof(struct input_event)) > -1);
-
-    /* get name of device */
-    ioctl(x->x_fd, EVIOCGNAME(sizeof(device_name)), device_name);
-    post ("[hidio] opened device %d (%s): %s",
-	  x->x_device_number,block_device,device_name);
-
-    post("pre hidio_build_element_list");
-    hidio_build_element_list(x);
-
-    return EXIT_SUCCESS;
+    x->x_core = hidio_core_open(device_number);
+    /* test if device open */
+    if(x->x_core == NULL) 
+    { 
+        error("[hidio] open %s%d failed",LINUX_BLOCK_DEVICE,device_number);
+        return EXIT_FAILURE;
+    }
+    return linux_setup_device(x);
 }
 
 /* Under GNU/Linux, the device is a filehandle */
-// TODO: return the same as POSIX open()/close() - 0=success, -1=fail
 t_int hidio_close_device(t_hidio *x)
 {
     debug_post(LOG_DEBUG,"hidio_close_device");
-    if(x->x_fd > -1) 
-	return (close(x->x_fd));
-    else
-	return EXIT_SUCCESS;
+    hidio_core_close(x->x_core);
+    x->x_core = NULL;
+    return EXIT_SUCCESS;
 }
 
 
+/* the blocking part of hidio_build_device_list(), it makes no Pd calls so that
+ * [async 1( can run it on the worker thread.  device_names[i] stays empty when
+ * there is nothing on /dev/input/event<i> */
+static void linux_scan_devices(char (*device_names)[MAXPDSTRING])
+{
+    unsigned int i;
+    
+    for(i=0; i<MAX_DEVICES; ++i)
+	{
+	    if(hidio_core_device_name(i, device_names[i], MAXPDSTRING) < 0)
+		device_names[i][0] = '\0';
+	}
+}
+
+static void linux_post_devices(char (*device_names)[MAXPDSTRING])
+{
+    unsigned int i;
+    unsigned int last_active_device = 0;
+
+    for(i=0; i<MAX_DEVICES; ++i)
+	{
+	    if(device_names[i][0])
+		post("Found '%s' on '%s%d'",device_names[i], LINUX_BLOCK_DEVICE, i);
+	    last_active_device = i;
+	}
+    hidio_device_count = last_active_device ; // set the global variable
+    debug_post(LOG_WARNING,"[hidio] completed device list.");
+}
+
 void hidio_build_device_list(void)
 {
     /*
@@ -465,44 +692,25 @@ void hidio_build_device_list(void)
      * the device list.  Once the device name can be other things in addition
      * the current t_float, then this will probably need to be changed.
      */
-    int fd;
-    unsigned int i;
-    unsigned int last_active_device = 0;
-    char device_name[MAXPDSTRING] = "Unknown";
-    char block_device[MAXPDSTRING] = "/dev/input/event0";
-    struct input_event  x_input_event; 
+    char (*device_names)[MAXPDSTRING];
     
     debug_post(LOG_DEBUG,"hidio_build_device_list");
     
     debug_post(LOG_WARNING,"[hidio] Building device list...");
     
-    for(i=0; i<MAX_DEVICES; ++i)
-	{
-	    snprintf(block_device, MAXPDSTRING, "%s%d", LINUX_BLOCK_DEVICE, i);
-	    /* open the device read-only, non-exclusive */
-	    fd = open (block_device, O_RDONLY | O_NONBLOCK);
-	    /* test if device open */
-	    if(fd < 0 ) { 
-		/* post("Nothing on %s.", &block_device); */
-		fd = -1;
-	    } else {
-		/* read input_events from the LINUX_BLOCK_DEVICE stream 
-		 * It seems that is just there to flush the event input buffer? */
-		while( read(fd, &(x_input_event),sizeof(struct input_event)) > -1 );
-			  
-		/* get name of device */
-		ioctl(fd, EVIOCGNAME(sizeof(device_name)), device_name);
-		post("Found '%s' on '%s'",device_name, &block_device);
+    device_names = getbytes(MAX_DEVICES * MAXPDSTRING);
+    linux_scan_devices(device_names);
+    linux_post_devices(device_names);
+    freebytes(device_names, MAX_DEVICES * MAXPDSTRING);
+}
 
-		close (fd);
-	    }
-	    last_active_device = i;
 
-	}
-    device_count = last_active_device ; // set the global variable
-    debug_post(LOG_WARNING,"[hidio] completed device list.");
-}
 
+void hidio_print(t_hidio *x)
+{
+    hidio_devices(x);
+    if (x->x_device_open) hidio_elements(x);
+}
 
 
 void hidio_platform_specific_free(t_hidio *x)
@@ -520,9 +728,11 @@ void hidio_platform_specific_info(t_hidio* x)
     char product_string[MAXPDSTRING] = "Unknown";
     char vendorid_string[7];
     char productid_string[7];
-    t_atom *output_atom = getbytes(sizeof(t_atom));
+    t_atom *output_atom;
   
-    ioctl(x->x_fd, EVIOCGID, &my_id);
+    if(x->x_core == NULL) return;
+    output_atom = getbytes(sizeof(t_atom));
+    ioctl(x->x_core->fd, EVIOCGID, &my_id);
     snprintf(vendorid_string,7,"0x%04x", my_id.vendor);
     SETSYMBOL(output_atom, gensym(vendorid_string));
     outlet_anything( x->x_status_outlet, gensym("vendorID"), 
@@ -531,7 +741,7 @@ void hidio_platform_specific_info(t_hidio* x)
     SETSYMBOL(output_atom, gensym(productid_string));
     outlet_anything( x->x_status_outlet, gensym("productID"), 
 		     1, output_atom);
-    ioctl(x->x_fd, EVIOCGNAME(sizeof(product_string)), product_string);
+    ioctl(x->x_core->fd, EVIOCGNAME(sizeof(product_string)), product_string);
     SETSYMBOL(output_atom, gensym(product_string));
     outlet_anything( x->x_status_outlet, gensym("product"), 
 		     1, output_atom);
@@ -554,6 +764,7 @@ short get_device_number_by_id(unsigned short vendor_id, unsigned short product_i
 		if(fd > -1 ) 
 		{
 			ioctl(fd, EVIOCGID, &my_id);
+			close(fd);
 			if( (vendor_id == my_id.vendor) && (product_id == my_id.product) )
 				return i;
 		}
@@ -562,25 +773,367 @@ short get_device_number_by_id(unsigned short vendor_id, unsigned short product_i
     return -1;
 }
 
+/* guess the HID usage of an evdev device from the events it can send, evdev
+ * has no usage pages, only the capability bits */
+static unsigned char linux_device_has_usage(int fd, unsigned short usage_page, 
+                                            unsigned short usage)
+{
+    unsigned long key_bitmask[NBITS(KEY_MAX)];
+    unsigned long rel_bitmask[NBITS(REL_MAX)];
+    unsigned long abs_bitmask[NBITS(ABS_MAX)];
+
+    if(usage_page != 0x01) /* Generic Desktop */
+        return 0;
+    memset(key_bitmask, 0, sizeof(key_bitmask));
+    memset(rel_bitmask, 0, sizeof(rel_bitmask));
+    memset(abs_bitmask, 0, sizeof(abs_bitmask));
+    ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bitmask)), key_bitmask);
+    ioctl(fd, EVIOCGBIT(EV_REL, sizeof(rel_bitmask)), rel_bitmask);
+    ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(abs_bitmask)), abs_bitmask);
+    switch(usage)
+    {
+    case 0x01: /* pointer */
+        return test_bit(BTN_TOUCH, key_bitmask) || 
+            test_bit(BTN_TOOL_PEN, key_bitmask) ||
+            linux_device_has_usage(fd, usage_page, 0x02);
+    case 0x02: /* mouse */
+        return test_bit(REL_X, rel_bitmask) && test_bit(BTN_MOUSE, key_bitmask);
+    case 0x04: /* joystick, gamepads are joysticks to most patches */
+        return test_bit(ABS_X, abs_bitmask) && 
+            (test_bit(BTN_JOYSTICK, key_bitmask) || test_bit(BTN_GAMEPAD, key_bitmask));
+    case 0x05: /* gamepad */
+        return test_bit(BTN_GAMEPAD, key_bitmask);
+    case 0x06: /* keyboard */
+        return test_bit(KEY_A, key_bitmask) && test_bit(KEY_Z, key_bitmask);
+    case 0x07: /* keypad */
+        return test_bit(KEY_KP0, key_bitmask) && test_bit(KEY_KP9, key_bitmask);
+    case 0x08: /* multiaxiscontroller */
+        return test_bit(ABS_RX, abs_bitmask) && test_bit(ABS_RY, abs_bitmask) &&
+            test_bit(ABS_RZ, abs_bitmask);
+    }
+    return 0;
+}
+
+/* device_number is the instance, i.e. 0 is the first joystick, 1 the second */
 short get_device_number_from_usage(short device_number, 
 				   unsigned short usage_page, 
 				   unsigned short usage)
 {
+    char block_device[FILENAME_MAX];
+    unsigned char found;
+    short i, instance = 0;
+    int fd;
 
+    for(i=0; i<MAX_DEVICES; ++i)
+    {
+        snprintf(block_device, FILENAME_MAX, "%s%d", LINUX_BLOCK_DEVICE, i);
+        fd = open(block_device, O_RDONLY | O_NONBLOCK);
+        if(fd < 0)
+            continue;
+        found = linux_device_has_usage(fd, usage_page, usage);
+        close(fd);
+        if(found && (instance++ == device_number))
+            return i;
+    }
     return -1;
 }
 
+/* ------------------------------------------------------------------------------ */
+/* MULTI-DEVICE MODE, [open-all( */
+/* ------------------------------------------------------------------------------ */
+
+/* opens all devices in x_multi_devices and puts them into one epoll set, so a
+ * tick only needs a single epoll_wait() to find the ones with events */
+t_int hidio_open_multi(t_hidio *x)
+{
+    struct epoll_event event;
+    t_int k, opened = 0;
+
+    x->x_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(x->x_epoll_fd < 0)
+    {
+        pd_error(x, "[hidio] epoll_create1: %s", strerror(errno));
+        return 0;
+    }
+    for(k = 0; k < x->x_multi_count; ++k)
+    {
+        if(hidio_open_device(x, x->x_multi_devices[k]) != EXIT_SUCCESS)
+            continue;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = opened;
+        if(epoll_ctl(x->x_epoll_fd, EPOLL_CTL_ADD, x->x_core->fd, &event) < 0)
+        {
+            pd_error(x, "[hidio] epoll_ctl: %s", strerror(errno));
+            hidio_core_close(x->x_core);
+            continue;
+        }
+        x->x_multi_devices[opened] = x->x_multi_devices[k];
+        x->x_multi_cores[opened] = x->x_core;
+        ++opened;
+    }
+    x->x_multi_count = opened;
+    x->x_core = NULL;
+    if(opened == 0)
+    {
+        close(x->x_epoll_fd);
+        x->x_epoll_fd = -1;
+    }
+    return opened;
+}
+
+void hidio_close_multi(t_hidio *x)
+{
+    t_int k;
+    for(k = 0; k < x->x_multi_count; ++k)
+        hidio_core_close(x->x_multi_cores[k]);
+    if(x->x_epoll_fd > -1)
+        close(x->x_epoll_fd);
+    x->x_epoll_fd = -1;
+    x->x_core = NULL;
+}
+
+/* marks the devices that have events waiting, without blocking */
+int hidio_get_ready_multi(t_hidio *x, unsigned char *ready)
+{
+    struct epoll_event events[MAX_MULTI_DEVICES];
+    int i, count;
+
+    count = epoll_wait(x->x_epoll_fd, events, MAX_MULTI_DEVICES, 0);
+    for(i = 0; i < count; ++i)
+        ready[events[i].data.u32] = 1;
+    return count;
+}
+
+/* makes device index the current one for hidio_get_events() and the output */
+void hidio_select_multi(t_hidio *x, int index)
+{
+    x->x_core = x->x_multi_cores[index];
+    x->x_device_number = x->x_multi_devices[index];
+}
+
+/* what ties the nodes of one physical device together: the phys path without
+ * the trailing /inputN, the uniq string (i.e. the Bluetooth address) and the
+ * sysfs device that the input devices hang off */
+typedef struct _linux_device_key
+{
+    char phys[MAXPDSTRING];
+    char uniq[MAXPDSTRING];
+    char parent[FILENAME_MAX];
+} t_linux_device_key;
+
+static t_int linux_get_device_key(short device_number, t_linux_device_key *key)
+{
+    char block_device[FILENAME_MAX];
+    char *slash;
+    int fd;
+
+    memset(key, 0, sizeof(t_linux_device_key));
+    snprintf(block_device, FILENAME_MAX, "%s%d", LINUX_BLOCK_DEVICE, device_number);
+    fd = open(block_device, O_RDONLY | O_NONBLOCK);
+    if(fd < 0)
+        return EXIT_FAILURE;
+    ioctl(fd, EVIOCGPHYS(sizeof(key->phys) - 1), key->phys);
+    ioctl(fd, EVIOCGUNIQ(sizeof(key->uniq) - 1), key->uniq);
+    close(fd);
+    slash = strrchr(key->phys, '/');
+    if(slash)
+        *slash = '\0';
+    snprintf(block_device, FILENAME_MAX, "/sys/class/input/event%d/device/device", 
+             device_number);
+    if(realpath(block_device, key->parent) == NULL)
+        key->parent[0] = '\0';
+    return EXIT_SUCCESS;
+}
+
+static unsigned char linux_same_device(t_linux_device_key *a, t_linux_device_key *b)
+{
+    return (a->phys[0] && (strcmp(a->phys, b->phys) == 0)) ||
+        (a->uniq[0] && (strcmp(a->uniq, b->uniq) == 0)) ||
+        (a->parent[0] && (strcmp(a->parent, b->parent) == 0));
+}
+
+t_int hidio_get_siblings(short device_number, short *siblings)
+{
+    t_linux_device_key device_key, other_key;
+    t_int count = 0;
+    short i;
+
+    siblings[count++] = device_number;
+    if(linux_get_device_key(device_number, &device_key) != EXIT_SUCCESS)
+        return count;
+    for(i=0; (i<MAX_DEVICES) && (count<MAX_MULTI_DEVICES); ++i)
+    {
+        if( (i == device_number) || 
+            (linux_get_device_key(i, &other_key) != EXIT_SUCCESS) )
+            continue;
+        if(linux_same_device(&device_key, &other_key))
+        {
+            debug_post(LOG_INFO,"[hidio] event%d is part of event%d", i, device_number);
+            siblings[count++] = i;
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------------ */
+/* ASYNCHRONOUS OPEN AND REFRESH, [async 1( */
+/* ------------------------------------------------------------------------------ */
+
+#define LINUX_ASYNC_RUNNING 0
+#define LINUX_ASYNC_DONE 1
+#define LINUX_ASYNC_ABANDONED 2
+
+/* everything the worker touches, so that it never needs the t_hidio, which
+ * can be gone by the time a slow device answers.  Whichever side comes last,
+ * the worker finishing or hidio_async_discard(), frees it */
+typedef struct _linux_async
+{
+    t_hidio_async_job job;
+    t_hidio_open_args args;
+    t_hidio_core_device *core; /* opened by the worker */
+    char (*names)[MAXPDSTRING]; /* found by the worker */
+    int state; /* LINUX_ASYNC_*, changed atomically */
+} t_linux_async;
+
+static void linux_async_free(t_linux_async *work)
+{
+    hidio_core_close(work->core);
+    free(work->names);
+    free(work);
+}
+
+/* only the probing and hidio_core_open() happen here, everything that touches
+ * Pd or the element tables is left to hidio_async_finish() on the main thread */
+static void *linux_async_worker(void *arg)
+{
+    t_linux_async *work = (t_linux_async *)arg;
+    int running = LINUX_ASYNC_RUNNING;
+
+    if(work->job == ASYNC_REFRESH)
+        linux_scan_devices(work->names);
+    else
+    {
+        work->args.device_number = hidio_resolve_open_args(&work->args);
+        if(work->args.device_number > -1)
+            work->core = hidio_core_open(work->args.device_number);
+    }
+    if(!__atomic_compare_exchange_n(&work->state, &running, LINUX_ASYNC_DONE, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        linux_async_free(work); /* the object was freed meanwhile */
+    return NULL;
+}
+
+static t_int linux_async_start(t_hidio *x, char (*names)[MAXPDSTRING])
+{
+    t_linux_async *work;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int err;
+
+    work = (t_linux_async *)calloc(1, sizeof(t_linux_async));
+    if(work == NULL)
+    {
+        free(names);
+        pd_error(x, "[hidio] could not start the worker thread: %s", strerror(ENOMEM));
+        return EXIT_FAILURE;
+    }
+    work->job = x->x_async_job;
+    work->args = x->x_async_args;
+    work->names = names;
+    work->state = LINUX_ASYNC_RUNNING;
+    /* nobody joins it, hidio_free() must not wait for a hung device */
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    err = pthread_create(&thread, &attr, linux_async_worker, work);
+    pthread_attr_destroy(&attr);
+    if(err != 0)
+    {
+        linux_async_free(work);
+        pd_error(x, "[hidio] could not start the worker thread: %s", strerror(err));
+        return EXIT_FAILURE;
+    }
+    x->x_async_work = work;
+    return EXIT_SUCCESS;
+}
+
+t_int hidio_async_open(t_hidio *x)
+{
+    return linux_async_start(x, NULL);
+}
+
+t_int hidio_async_refresh(t_hidio *x)
+{
+    char (*names)[MAXPDSTRING];
+
+    debug_post(LOG_WARNING,"[hidio] Building device list...");
+    names = calloc(MAX_DEVICES, MAXPDSTRING);
+    if(names == NULL)
+        return EXIT_FAILURE;
+    return linux_async_start(x, names);
+}
+
+t_int hidio_async_done(t_hidio *x)
+{
+    if( (x->x_async_work == NULL) ||
+        (__atomic_load_n(&x->x_async_work->state, __ATOMIC_ACQUIRE) != LINUX_ASYNC_DONE) )
+        return 0;
+    /* hidio_async_tick() looks at what the worker resolved */
+    x->x_async_args.device_number = x->x_async_work->args.device_number;
+    return 1;
+}
+
+t_int hidio_async_finish(t_hidio *x)
+{
+    t_linux_async *work = x->x_async_work;
+
+    x->x_async_work = NULL;
+    if(work->job == ASYNC_REFRESH)
+    {
+        linux_post_devices(work->names);
+        linux_async_free(work);
+        return EXIT_SUCCESS;
+    }
+    if(work->core == NULL)
+    {
+        error("[hidio] open %s%d failed", LINUX_BLOCK_DEVICE, 
+              work->args.device_number);
+        linux_async_free(work);
+        return EXIT_FAILURE;
+    }
+    x->x_core = work->core;
+    work->core = NULL;
+    x->x_device_number = work->args.device_number;
+    linux_async_free(work);
+    return linux_setup_device(x);
+}
+
+void hidio_async_discard(t_hidio *x)
+{
+    t_linux_async *work = x->x_async_work;
+    int running = LINUX_ASYNC_RUNNING;
+
+    if(work == NULL)
+        return;
+    x->x_async_work = NULL;
+    /* a worker that is still busy sees this and frees it when it is done */
+    if(!__atomic_compare_exchange_n(&work->state, &running, LINUX_ASYNC_ABANDONED, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        linux_async_free(work);
+}
+
 void hidio_write_event_JMZ(t_hidio *x, t_symbol *type, t_symbol *code, 
 		       t_float instance, t_float value)
 {
     struct input_event write_event;
 		
+    if(x->x_core == NULL) return;
     post("%s %s %d", type->s_name, code->s_name, value);
     write_event.type = strtol(type->s_name, NULL, 16);
     write_event.code = strtol(code->s_name, NULL, 16);
     write_event.value = (int) value;
 	
-    write(x->x_fd, (const void*) &write_event, sizeof(write_event));	
+    write(x->x_core->fd, (const void*) &write_event, sizeof(write_event));	
 }
 
 
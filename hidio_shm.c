@@ -0,0 +1,351 @@
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* shared memory event ring, see hidio_shm.h                                 */
+/*                                                                           */
+/* Like hidio_core_linux.c, nothing in here calls Pd or Max, so other        */
+/* programs can read the ring by just compiling this file.                   */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hidio_shm.h"
+
+#ifndef _WIN32
+
+/* the ring is built on the GCC/clang __atomic builtins */
+#ifndef __ATOMIC_ACQUIRE
+#error "hidio_shm.c needs a compiler with the __atomic builtins, e.g. GCC or clang"
+#endif /* NOT __ATOMIC_ACQUIRE */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void shm_path(char *path, const char *name)
+{
+    snprintf(path, HIDIO_SHM_NAME_SIZE, "/hidio.%s", name);
+}
+
+static t_hidio_shm *shm_map(const char *name, int publisher)
+{
+    t_hidio_shm *shm;
+    struct stat shm_stat;
+    void *mapped;
+    int fd;
+
+    shm = (t_hidio_shm *)calloc(1, sizeof(t_hidio_shm));
+    if(shm == NULL)
+        return NULL;
+    shm_path(shm->name, name);
+    shm->publisher = publisher;
+    if(publisher)
+        fd = shm_open(shm->name, O_RDWR | O_CREAT, 0644);
+    else
+        fd = shm_open(shm->name, O_RDONLY, 0);
+    if(fd < 0)
+    {
+        free(shm);
+        return NULL;
+    }
+    if(publisher && (ftruncate(fd, sizeof(t_hidio_shm_region)) < 0))
+        goto failed;
+    if(fstat(fd, &shm_stat) < 0)
+        goto failed;
+    if(shm_stat.st_size < (off_t)sizeof(t_hidio_shm_region))
+    {
+        errno = EINVAL; /* not published yet, or a different version */
+        goto failed;
+    }
+    mapped = mmap(NULL, sizeof(t_hidio_shm_region),
+                  publisher ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if(mapped == MAP_FAILED)
+        goto failed;
+    close(fd);
+    shm->region = (t_hidio_shm_region *)mapped;
+    return shm;
+
+failed:
+    close(fd);
+    free(shm);
+    return NULL;
+}
+
+/* pid and a serial number, so that two publishers in one process differ too */
+static uint64_t shm_new_writer(void)
+{
+    static uint32_t serial = 0;
+
+    return ((uint64_t)getpid() << 32) | __atomic_add_fetch(&serial, 1, __ATOMIC_RELAXED);
+}
+
+/* the ring has room for only one writer, the first one to swap its id into
+ * the region gets it.  A writer whose process is gone can be replaced */
+static int shm_claim_writer(t_hidio_shm *shm)
+{
+    t_hidio_shm_region *region = shm->region;
+    uint64_t writer = __atomic_load_n(&region->writer, __ATOMIC_ACQUIRE);
+    pid_t pid;
+
+    while(1)
+    {
+        if(writer != 0)
+        {
+            pid = (pid_t)(writer >> 32);
+            if( (kill(pid, 0) == 0) || (errno == EPERM) )
+            {
+                errno = EBUSY;
+                return -1;
+            }
+        }
+        if(__atomic_compare_exchange_n(&region->writer, &writer, shm->writer, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return 0;
+    }
+}
+
+t_hidio_shm *hidio_shm_publish(const char *name)
+{
+    t_hidio_shm *shm = shm_map(name, 1);
+    t_hidio_shm_region *region;
+
+    if(shm == NULL)
+        return NULL;
+    shm->writer = shm_new_writer();
+    region = shm->region;
+    /* a publisher that crashed leaves its region behind, the readers still
+     * attached to it keep going, so only start from scratch with a new one */
+    if( (region->magic != HIDIO_SHM_MAGIC) || (region->version != HIDIO_SHM_VERSION) )
+    {
+        memset(region, 0, sizeof(t_hidio_shm_region));
+        region->version = HIDIO_SHM_VERSION;
+        region->ring_size = HIDIO_SHM_RING_SIZE;
+        region->max_elements = HIDIO_SHM_MAX_ELEMENTS;
+        region->device_number = -1;
+        __atomic_store_n(&region->magic, HIDIO_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+    if(shm_claim_writer(shm) < 0)
+    {
+        munmap(shm->region, sizeof(t_hidio_shm_region));
+        free(shm);
+        return NULL;
+    }
+    __atomic_store_n(&region->closed, 0, __ATOMIC_RELEASE);
+    return shm;
+}
+
+t_hidio_shm *hidio_shm_attach(const char *name)
+{
+    t_hidio_shm *shm = shm_map(name, 0);
+
+    if(shm == NULL)
+        return NULL;
+    if( (__atomic_load_n(&shm->region->magic, __ATOMIC_ACQUIRE) != HIDIO_SHM_MAGIC) ||
+        (shm->region->version != HIDIO_SHM_VERSION) ||
+        (shm->region->ring_size != HIDIO_SHM_RING_SIZE) )
+    {
+        munmap(shm->region, sizeof(t_hidio_shm_region));
+        free(shm);
+        errno = EINVAL;
+        return NULL;
+    }
+    /* hidio_shm_get_elements() sets where reading starts */
+    shm->read_index = __atomic_load_n(&shm->region->write_index, __ATOMIC_ACQUIRE);
+    return shm;
+}
+
+void hidio_shm_close(t_hidio_shm *shm)
+{
+    if(shm == NULL)
+        return;
+    if(shm->publisher)
+    {
+        __atomic_store_n(&shm->region->closed, 1, __ATOMIC_RELEASE);
+        shm_unlink(shm->name);
+        __atomic_store_n(&shm->region->writer, 0, __ATOMIC_RELEASE);
+    }
+    munmap(shm->region, sizeof(t_hidio_shm_region));
+    free(shm);
+}
+
+/* ------------------------------------------------------------------------------ */
+/* WRITER */
+/* ------------------------------------------------------------------------------ */
+
+void hidio_shm_begin_elements(t_hidio_shm *shm)
+{
+    t_hidio_shm_region *region = shm->region;
+
+    __atomic_store_n(&region->generation, region->generation + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void hidio_shm_set_element(t_hidio_shm *shm, unsigned int id, const char *type,
+                           const char *name, int instance, int min, int max,
+                           int relative, int value)
+{
+    t_hidio_shm_element *shm_element;
+
+    if(id >= HIDIO_SHM_MAX_ELEMENTS)
+        return;
+    shm_element = shm->region->elements + id;
+    memset(shm_element, 0, sizeof(t_hidio_shm_element));
+    snprintf(shm_element->type, HIDIO_SHM_SYMBOL_SIZE, "%s", type);
+    snprintf(shm_element->name, HIDIO_SHM_SYMBOL_SIZE, "%s", name);
+    shm_element->instance = instance;
+    shm_element->min = min;
+    shm_element->max = max;
+    shm_element->relative = (relative != 0);
+    __atomic_store_n(shm->region->values + id, relative ? 0 : value, __ATOMIC_RELAXED);
+}
+
+void hidio_shm_end_elements(t_hidio_shm *shm, int device_number,
+                            unsigned int count)
+{
+    t_hidio_shm_region *region = shm->region;
+
+    region->device_number = device_number;
+    region->num_elements = (count < HIDIO_SHM_MAX_ELEMENTS) ? count : HIDIO_SHM_MAX_ELEMENTS;
+    __atomic_store_n(&region->generation, region->generation + 1, __ATOMIC_RELEASE);
+}
+
+void hidio_shm_write(t_hidio_shm *shm, unsigned int id, int value, double timestamp)
+{
+    t_hidio_shm_region *region = shm->region;
+    uint64_t index = region->write_index; /* there is only one writer */
+    t_hidio_shm_slot *slot = region->ring + (index & (HIDIO_SHM_RING_SIZE - 1));
+    uint64_t timestamp_bits;
+
+    if(id >= HIDIO_SHM_MAX_ELEMENTS)
+        return;
+    memcpy(&timestamp_bits, &timestamp, sizeof(timestamp_bits));
+    __atomic_store_n(&slot->sequence, 2 * index + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&slot->id, id, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->value, value, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->timestamp, timestamp_bits, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->sequence, 2 * index + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(region->values + id, value, __ATOMIC_RELAXED);
+    __atomic_store_n(&region->write_index, index + 1, __ATOMIC_RELEASE);
+}
+
+/* ------------------------------------------------------------------------------ */
+/* READERS */
+/* ------------------------------------------------------------------------------ */
+
+int hidio_shm_elements_changed(t_hidio_shm *shm)
+{
+    return __atomic_load_n(&shm->region->generation, __ATOMIC_ACQUIRE) != shm->generation;
+}
+
+int hidio_shm_get_elements(t_hidio_shm *shm, t_hidio_shm_element *elements,
+                           int32_t *values, unsigned int max_elements,
+                           int *device_number)
+{
+    t_hidio_shm_region *region = shm->region;
+    uint32_t generation;
+    uint64_t write_index;
+    unsigned int i, count;
+
+    generation = __atomic_load_n(&region->generation, __ATOMIC_ACQUIRE);
+    if(generation & 1)
+        return -1;
+    /* events from here on are newer than the values copied below */
+    write_index = __atomic_load_n(&region->write_index, __ATOMIC_ACQUIRE);
+    count = region->num_elements;
+    if(count > max_elements)
+        count = max_elements;
+    *device_number = region->device_number;
+    memcpy(elements, (const void *)region->elements, count * sizeof(t_hidio_shm_element));
+    for(i = 0; i < count; ++i)
+        values[i] = __atomic_load_n(region->values + i, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&region->generation, __ATOMIC_RELAXED) != generation)
+        return -1;
+    shm->generation = generation;
+    shm->read_index = write_index;
+    return count;
+}
+
+int hidio_shm_read(t_hidio_shm *shm, t_hidio_shm_event *events, int max_events)
+{
+    t_hidio_shm_region *region = shm->region;
+    t_hidio_shm_slot *slot;
+    t_hidio_shm_event *event;
+    uint64_t write_index, sequence, timestamp_bits;
+    int count = 0;
+
+    write_index = __atomic_load_n(&region->write_index, __ATOMIC_ACQUIRE);
+    if(write_index - shm->read_index > HIDIO_SHM_RING_SIZE)
+    {
+        /* lapped, the oldest ones are gone */
+        shm->lost += write_index - shm->read_index - HIDIO_SHM_RING_SIZE;
+        shm->read_index = write_index - HIDIO_SHM_RING_SIZE;
+    }
+    while( (count < max_events) && (shm->read_index < write_index) )
+    {
+        slot = region->ring + (shm->read_index & (HIDIO_SHM_RING_SIZE - 1));
+        event = events + count;
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        event->id = __atomic_load_n(&slot->id, __ATOMIC_RELAXED);
+        event->value = __atomic_load_n(&slot->value, __ATOMIC_RELAXED);
+        timestamp_bits = __atomic_load_n(&slot->timestamp, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        ++shm->read_index;
+        /* the writer came round again while this was copied */
+        if( (sequence != 2 * shm->read_index) ||
+            (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence) )
+        {
+            ++shm->lost;
+            continue;
+        }
+        memcpy(&event->timestamp, &timestamp_bits, sizeof(event->timestamp));
+        ++count;
+    }
+    return count;
+}
+
+int hidio_shm_closed(t_hidio_shm *shm)
+{
+    return __atomic_load_n(&shm->region->closed, __ATOMIC_ACQUIRE);
+}
+
+#else /* _WIN32 */
+
+/* there is no shm_open() on Windows, so publishing is not supported there */
+
+t_hidio_shm *hidio_shm_publish(const char *name)
+{
+    errno = ENOSYS;
+    return NULL;
+}
+
+t_hidio_shm *hidio_shm_attach(const char *name)
+{
+    errno = ENOSYS;
+    return NULL;
+}
+
+void hidio_shm_close(t_hidio_shm *shm) {}
+void hidio_shm_begin_elements(t_hidio_shm *shm) {}
+void hidio_shm_set_element(t_hidio_shm *shm, unsigned int id, const char *type,
+                           const char *name, int instance, int min, int max,
+                           int relative, int value) {}
+void hidio_shm_end_elements(t_hidio_shm *shm, int device_number,
+                            unsigned int count) {}
+void hidio_shm_write(t_hidio_shm *shm, unsigned int id, int value, double timestamp) {}
+int hidio_shm_elements_changed(t_hidio_shm *shm) { return 0; }
+int hidio_shm_get_elements(t_hidio_shm *shm, t_hidio_shm_element *elements,
+                           int32_t *values, unsigned int max_elements,
+                           int *device_number) { return -1; }
+int hidio_shm_read(t_hidio_shm *shm, t_hidio_shm_event *events, int max_events) { return 0; }
+int hidio_shm_closed(t_hidio_shm *shm) { return 1; }
+
+#endif /* NOT _WIN32 */
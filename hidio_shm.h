@@ -0,0 +1,120 @@
+#ifndef _HIDIO_SHM_H
+#define _HIDIO_SHM_H
+
+/* --------------------------------------------------------------------------*/
+/*                                                                           */
+/* an event ring in POSIX shared memory, so that one [hidio] reading a       */
+/* device can serve any number of other processes.  [publish name( writes    */
+/* every event of the open device into /hidio.<name>, [hidio -shm name] and  */
+/* other programs using this header read them from there.                    */
+/*                                                                           */
+/* There is one writer and any number of readers, and no locks: each slot    */
+/* of the ring has a sequence number that is odd while it is being written,  */
+/* and readers that fall more than a ring behind skip ahead and count what   */
+/* they lost.  The element table uses the same scheme with a generation      */
+/* number, and the last value of each element is kept so that late readers   */
+/* start from the current state.                                             */
+/*                                                                           */
+/* See file LICENSE for further informations on licensing terms.             */
+/*                                                                           */
+/* --------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+#define HIDIO_SHM_MAGIC 0x6869646f /* "hido" */
+#define HIDIO_SHM_VERSION 2
+/* events a reader can fall behind before it loses some, a power of 2 */
+#define HIDIO_SHM_RING_SIZE 4096
+#define HIDIO_SHM_MAX_ELEMENTS 512
+#define HIDIO_SHM_SYMBOL_SIZE 32
+#define HIDIO_SHM_NAME_SIZE 256
+
+/* an element as [hidio] outputs it: [absolute x 0 ( etc. */
+typedef struct _hidio_shm_element
+{
+    char type[HIDIO_SHM_SYMBOL_SIZE];
+    char name[HIDIO_SHM_SYMBOL_SIZE];
+    int32_t instance;
+    int32_t min;
+    int32_t max;
+    uint8_t relative; /* events are deltas */
+    uint8_t padding[3];
+} t_hidio_shm_element;
+
+typedef struct _hidio_shm_slot
+{
+    uint64_t sequence; /* 2 * index + 2 once written, odd while writing */
+    uint32_t id;
+    int32_t value;
+    uint64_t timestamp; /* the bits of the double */
+} t_hidio_shm_slot;
+
+/* what is in the shared memory, the same in every process */
+typedef struct _hidio_shm_region
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_size;
+    uint32_t max_elements;
+    uint32_t closed; /* the publisher went away */
+    uint32_t generation; /* of the element table, odd while writing */
+    int32_t device_number; /* of the publisher, -1 when it has none open */
+    uint32_t num_elements;
+    uint64_t writer; /* pid << 32 | serial of the publisher, 0 when there is none */
+    t_hidio_shm_element elements[HIDIO_SHM_MAX_ELEMENTS];
+    int32_t values[HIDIO_SHM_MAX_ELEMENTS]; /* the last event of each element */
+    uint64_t write_index; /* events written so far */
+    t_hidio_shm_slot ring[HIDIO_SHM_RING_SIZE];
+} t_hidio_shm_region;
+
+typedef struct _hidio_shm_event
+{
+    uint32_t id; /* index into the element table */
+    int32_t value;
+    double timestamp; /* ms, the clock of hidio_get_system_time() */
+} t_hidio_shm_event;
+
+/* the private side of one writer or reader */
+typedef struct _hidio_shm
+{
+    t_hidio_shm_region *region;
+    char name[HIDIO_SHM_NAME_SIZE];
+    int publisher;
+    uint64_t writer; /* what the publisher put into region->writer */
+    uint64_t read_index;
+    uint32_t generation; /* of the element table last read */
+    unsigned long lost; /* events overwritten before they were read */
+} t_hidio_shm;
+
+/* create /hidio.<name> for writing, or take it over from a publisher that
+ * crashed.  NULL and errno on failure, EBUSY if another one publishes it */
+t_hidio_shm *hidio_shm_publish(const char *name);
+/* map /hidio.<name> for reading, NULL and errno if nobody publishes it */
+t_hidio_shm *hidio_shm_attach(const char *name);
+/* a publisher marks the region closed and removes the name */
+void hidio_shm_close(t_hidio_shm *shm);
+
+/* writer: replace the element table, set_element for ids 0 to count - 1
+ * between begin and end */
+void hidio_shm_begin_elements(t_hidio_shm *shm);
+void hidio_shm_set_element(t_hidio_shm *shm, unsigned int id, const char *type,
+                           const char *name, int instance, int min, int max,
+                           int relative, int value);
+void hidio_shm_end_elements(t_hidio_shm *shm, int device_number,
+                            unsigned int count);
+/* writer: one event, never blocks */
+void hidio_shm_write(t_hidio_shm *shm, unsigned int id, int value, double timestamp);
+
+/* reader: non-zero if the table changed since hidio_shm_get_elements() */
+int hidio_shm_elements_changed(t_hidio_shm *shm);
+/* reader: copy the table and the current values, and start reading events
+ * from here.  Returns the element count, or -1 while the publisher is
+ * writing the table, then try again later */
+int hidio_shm_get_elements(t_hidio_shm *shm, t_hidio_shm_element *elements,
+                           int32_t *values, unsigned int max_elements,
+                           int *device_number);
+/* reader: up to max_events new events, never blocks */
+int hidio_shm_read(t_hidio_shm *shm, t_hidio_shm_event *events, int max_events);
+int hidio_shm_closed(t_hidio_shm *shm);
+
+#endif  /* NOT _HIDIO_SHM_H */
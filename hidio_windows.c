@@ -79,7 +79,6 @@ typedef struct _hid_device_
  *  GLOBAL VARS
  *======================================================================== */
 
-extern t_int hidio_instance_count; // in hidio.h
 
 /* store device pointers so I don't have to query them all the time */
 // t_hid_devinfo device_pointer[MAX_DEVICES];
@@ -359,9 +358,9 @@ short get_device_number_by_id(unsigned short vendor_id, unsigned short product_i
 	char path[MAX_PATH];
 	char *pp = (char *)path;
 	short ret, i;
-	//short device_count = _hid_count_devices(); // mp20200205 doesn't set global
-    device_count = _hid_count_devices(); // mp20200205 set global
-	for (i = 0; i < device_count; i++)
+	//short hidio_device_count = _hid_count_devices(); // mp20200205 doesn't set global
+    hidio_device_count = _hid_count_devices(); // mp20200205 set global
+	for (i = 0; i < hidio_device_count; i++)
 	{
 		/* get path for specified device number */
 		ret = _hid_get_device_path(i, &pp, MAX_PATH);
@@ -395,9 +394,9 @@ short get_device_number_from_usage(short device_number,
 	char path[MAX_PATH];
 	char *pp = (char *)path;
 	short ret, i;
-	//short device_count = _hid_count_devices(); // mp20200205 doesn't set global
-    device_count = _hid_count_devices(); // mp20200205 set global
-	for (i = device_number; i < device_count; i++)
+	//short hidio_device_count = _hid_count_devices(); // mp20200205 doesn't set global
+    hidio_device_count = _hid_count_devices(); // mp20200205 set global
+	for (i = device_number; i < hidio_device_count; i++)
 	{
 		/* get path for specified device number */
 		ret = _hid_get_device_path(i, &pp, MAX_PATH);
@@ -445,12 +444,12 @@ static void convert_axis_to_symbols(t_hid_element *new_element, int array_index)
 	if (new_element->relative) 
 	{ 
 		new_element->type = ps_relative; 
-		new_element->name = relative_symbols[array_index];
+		new_element->name = hidio_relative_symbol(array_index);
 	}
 	else 
 	{ 
 		new_element->type = ps_absolute; 
-		new_element->name = absolute_symbols[array_index];
+		new_element->name = hidio_absolute_symbol(array_index);
 	}
 }
 
@@ -505,7 +504,7 @@ static void get_usage_symbols(unsigned short usage_page, unsigned short usage, t
 				debug_post(LOG_DEBUG, "HID_USAGE_GENERIC_HATSWITCH");
 				// TODO: this is still a mystery how to handle, due to USB HID vs. Linux input.h
 				new_element->type = ps_absolute; 
-				new_element->name = absolute_symbols[9]; /* hatswitch */
+				new_element->name = hidio_absolute_symbol(9); /* hatswitch */
 				break;
 			default:
 				debug_post(LOG_DEBUG, "DESKTOP");
@@ -521,12 +520,12 @@ static void get_usage_symbols(unsigned short usage_page, unsigned short usage, t
 		case HID_USAGE_SIMULATION_RUDDER: 
 			debug_post(LOG_DEBUG, "HID_USAGE_SIMULATION_RUDDER");
 			new_element->type = ps_absolute;
-			new_element->name = absolute_symbols[5]; /* rz */
+			new_element->name = hidio_absolute_symbol(5); /* rz */
 			break;
 		case HID_USAGE_SIMULATION_THROTTLE:
 			debug_post(LOG_DEBUG, "HID_USAGE_SIMULATION_THROTTLE");
 			new_element->type = ps_absolute;
-			new_element->name = absolute_symbols[6]; /* slider */
+			new_element->name = hidio_absolute_symbol(6); /* slider */
 			break;
 		default:
 			debug_post(LOG_DEBUG, "SIMULATION");
@@ -540,24 +539,24 @@ static void get_usage_symbols(unsigned short usage_page, unsigned short usage, t
 		new_element->type = ps_key;
 		if( (usage != 0xFFFF) && 
 			(usage < KEY_ARRAY_MAX) )
-			new_element->name = key_symbols[usage];
+			new_element->name = hidio_key_symbol(usage);
 		else /* PowerBook ADB keyboard reports 0xffffffff */
-			new_element->name = key_symbols[0];
+			new_element->name = hidio_key_symbol(0);
 		break;
 	case HID_USAGE_PAGE_BUTTON:
 	    debug_post(LOG_DEBUG, "HID_USAGE_PAGE_BUTTON");
 		new_element->type = ps_button;
-		new_element->name = button_symbols[usage];
+		new_element->name = hidio_button_symbol(usage);
 		break;
 	case HID_USAGE_PAGE_LED:
 	    debug_post(LOG_DEBUG, "HID_USAGE_PAGE_LED");
 		new_element->type = ps_led; 
-		new_element->name = led_symbols[usage];
+		new_element->name = hidio_led_symbol(usage);
 		break;
 	case HID_USAGE_PAGE_DIGITIZER:	/* no sure whether this is the right for PID in OS X */
 	    debug_post(LOG_DEBUG, "HID_USAGE_PAGE_DIGITIZER");
 		new_element->type = ps_pid; 
-		new_element->name = pid_symbols[usage];
+		new_element->name = hidio_pid_symbol(usage);
 		break;
 	default:
 	    debug_post(LOG_DEBUG, "HID_USAGE vendor defined");
@@ -585,7 +584,8 @@ static void hidio_build_element_list(t_hidio *x)
     USAGE              usage;
 	
 	debug_post(LOG_DEBUG, "=*=hidio_build_element_list=*=");
-	element_count[x->x_device_number] = 0;
+	hidio_element_count[x->x_device_number] = 0;
+	hidio_clear_element_values(x->x_device_number);
 	if (self->fh != INVALID_HANDLE_VALUE)
 	{
 	    debug_post(LOG_DEBUG, "hidio_build_element_list self->fh %d", self->fh);
@@ -706,8 +706,8 @@ static void hidio_build_element_list(t_hidio *x)
 					atom_setlong(new_element->output_message + 1, (long)new_element->instance);
 #endif /* PD */
        			    debug_post(LOG_DEBUG, "...new_element->name %s, new_element->instance %d", new_element->name->s_name, new_element->instance);
-					element[x->x_device_number][element_count[x->x_device_number]] = new_element;
-					++element_count[x->x_device_number];
+					hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
+					++hidio_element_count[x->x_device_number];
 				}
 			}
 			else
@@ -731,10 +731,10 @@ static void hidio_build_element_list(t_hidio *x)
 				atom_setlong(new_element->output_message + 1, (long)new_element->instance);
 #endif /* PD */
    			    debug_post(LOG_DEBUG, "..new_element->name %s, new_element->instance %d", new_element->name->s_name, new_element->instance);
-				element[x->x_device_number][element_count[x->x_device_number]] = new_element;
-				++element_count[x->x_device_number];
+				hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
+				++hidio_element_count[x->x_device_number];
 			}
-   			debug_post(LOG_DEBUG, ".element_count[%d]: %d", x->x_device_number, element_count[x->x_device_number]);
+   			debug_post(LOG_DEBUG, ".element_count[%d]: %d", x->x_device_number, hidio_element_count[x->x_device_number]);
 		}
 		/* get value data */
 		debug_post(LOG_DEBUG, "===Getting %d valueCaps===", self->caps.NumberInputValueCaps);
@@ -764,9 +764,9 @@ static void hidio_build_element_list(t_hidio *x)
 					atom_setsym(new_element->output_message, new_element->name);
 					atom_setlong(new_element->output_message + 1, (long)new_element->instance);
 #endif /* PD */
-					element[x->x_device_number][element_count[x->x_device_number]] = new_element;
+					hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
      			    debug_post(LOG_DEBUG, "...new_element->name %s, new_element->instance %d", new_element->name->s_name, new_element->instance);
-					++element_count[x->x_device_number];
+					++hidio_element_count[x->x_device_number];
 				}
 			} 
 			else
@@ -789,11 +789,11 @@ static void hidio_build_element_list(t_hidio *x)
 				atom_setsym(new_element->output_message, new_element->name);
 				atom_setlong(new_element->output_message + 1, (long)new_element->instance);
 #endif /* PD */
-				element[x->x_device_number][element_count[x->x_device_number]] = new_element;
+				hidio_element_table[x->x_device_number][hidio_element_count[x->x_device_number]] = new_element;
      			    debug_post(LOG_DEBUG, "..new_element->name %s, new_element->instance %d", new_element->name->s_name, new_element->instance);
-				++element_count[x->x_device_number];
+				++hidio_element_count[x->x_device_number];
 			}
-   			debug_post(LOG_DEBUG, ".element_count[%d]: %d", x->x_device_number, element_count[x->x_device_number]);
+   			debug_post(LOG_DEBUG, ".element_count[%d]: %d", x->x_device_number, hidio_element_count[x->x_device_number]);
 		}
 	}
     debug_post(LOG_DEBUG, "=*=hidio_build_element_list done.=*=");
@@ -807,15 +807,15 @@ t_int hidio_print_element_list(t_hidio *x)
 
 	debug_post(LOG_DEBUG,"hidio_print_element_list");
 
-	post("[hidio] found %d elements:", element_count[x->x_device_number]);
+	post("[hidio] found %d elements:", hidio_element_count[x->x_device_number]);
 	post("\nTYPE\tCODE#\tEVENT NAME\t\tmin-max");
 	post("--------------------------------------------------------------------");
-	for (i = 0; i < element_count[x->x_device_number]; i++)
+	for (i = 0; i < hidio_element_count[x->x_device_number]; i++)
 	{
-		current_element = element[x->x_device_number][i];
+		current_element = hidio_element_table[x->x_device_number][i];
 		post("  %s\t%d\t%s\t\t%d-%d", current_element->type->s_name,
 			 current_element->usage_id, current_element->name->s_name,
-			 current_element->min, current_element->max, current_element->value);
+			 current_element->min, current_element->max, ELEMENT_VALUE(current_element));
 	}
 	post("");
 
@@ -877,7 +877,7 @@ t_int hidio_print_device_list(t_hidio *x)
 			if (GetLastError() == ERROR_INSUFFICIENT_BUFFER) 
 			{ 
                 /* first call returned size of data, now call it again with the required size */
-				if (global_debug_level >= LOG_DEBUG) post("[hidio] need %lu bytes for data", BytesReturned); 
+				if (hidio_debug_level >= LOG_DEBUG) post("[hidio] need %lu bytes for data", BytesReturned); 
     			FunctionClassDeviceData.cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA);
     			Success = SetupDiGetDeviceInterfaceDetail(PnPHandle, 
 					&DeviceInterfaceData,
@@ -1114,7 +1114,7 @@ void hidio_platform_specific_info(t_hidio *x)
 		SETSYMBOL(output_atom, gensym(version_string));
 		outlet_anything( x->x_status_outlet, gensym("version"), 1, output_atom);
         /* type (the usage page?) */
-        current_element = element[devNr][0];
+        current_element = hidio_element_table[devNr][0];
         sprintf(device_type_buffer,"0x%04x", current_element->usage_page);
 		SETSYMBOL(output_atom, gensym(device_type_buffer));
 		outlet_anything( x->x_status_outlet, gensym("type"), 1, output_atom);
@@ -1130,22 +1130,26 @@ void hidio_get_events(t_hidio *x)
 	long bytesRead;
 	int devNr = x->x_device_number;
     debug_post(9,"hidio_get_events");
-	while ((bytesRead = _hidio_read(self)) > 0)
+	while (hidio_events_wanted(x) && ((bytesRead = _hidio_read(self)) > 0))
 	{
 		unsigned long i;
 		unsigned long size, length;
 		unsigned short *usages;
 		NTSTATUS result;
+		unsigned long usage_value;
+		long scaled_value;
+		/* reports carry no timestamp, so use the time they were read */
+		double report_time = hidio_get_system_time();
 
-       	debug_post(LOG_DEBUG,"hidio_get_events device %d (%d elements) got an event (%lu bytes):", devNr, element_count[devNr], bytesRead);
-		for (i = 0; i < element_count[devNr]; i++)
+       	debug_post(LOG_DEBUG,"hidio_get_events device %d (%d elements) got an event (%lu bytes):", devNr, hidio_element_count[devNr], bytesRead);
+		for (i = 0; i < hidio_element_count[devNr]; i++)
 		{
-			current_element = element[devNr][i];
+			current_element = hidio_element_table[devNr][i];
 
 			/* first try getting value data */
          	debug_post(LOG_DEBUG,"HidP_GetUsageValue for current_element[%d](at %p) usage_page 0x%02X, usage_id %d", i, current_element, current_element->usage_page, current_element->usage_id);
 			result = HidP_GetUsageValue(HidP_Input, current_element->usage_page, 0, current_element->usage_id,
-    			(unsigned long *)&current_element->value, 
+    			&usage_value, 
 				self->ppd, self->inputReportBuffer, self->caps.InputReportByteLength);
 			switch (result)
 			{
@@ -1172,12 +1176,16 @@ void hidio_get_events(t_hidio *x)
 			}
 			if (HIDP_STATUS_SUCCESS == result)
 			{
-            	debug_post(LOG_DEBUG,"***HidP_GetUsageValue %d", current_element->value);
+            	debug_post(LOG_DEBUG,"***HidP_GetUsageValue %d", usage_value);
+				/* a report holds the state of every element, so only changes are events */
+				if (current_element->relative ? (usage_value != 0) : 
+					((long)usage_value != ELEMENT_VALUE(current_element)))
+					hidio_element_update(x, current_element, (long)usage_value, report_time);
 				continue;
 			}
 			/* now try getting scaled value data */
          	debug_post(LOG_DEBUG,"HidP_GetScaledUsageValue for element %d (at %p) usage_page 0x%02X, usage_id %d", i, current_element, current_element->usage_page, current_element->usage_id);
-			result = HidP_GetScaledUsageValue(HidP_Input, current_element->usage_page, 0, current_element->usage_id, &current_element->value, 
+			result = HidP_GetScaledUsageValue(HidP_Input, current_element->usage_page, 0, current_element->usage_id, &scaled_value, 
 										self->ppd, self->inputReportBuffer, self->caps.InputReportByteLength);
 			switch (result)
 			{
@@ -1210,7 +1218,10 @@ void hidio_get_events(t_hidio *x)
 			}
 			if (HIDP_STATUS_SUCCESS == result)
 			{
-            	debug_post(LOG_DEBUG,"***HidP_GetScaledUsageValue %d", current_element->value);
+            	debug_post(LOG_DEBUG,"***HidP_GetScaledUsageValue %d", scaled_value);
+				if (current_element->relative ? (scaled_value != 0) : 
+					(scaled_value != ELEMENT_VALUE(current_element)))
+					hidio_element_update(x, current_element, scaled_value, report_time);
 				continue;
 			}
 
@@ -1233,10 +1244,10 @@ void hidio_get_events(t_hidio *x)
 					self->ppd, self->inputReportBuffer, self->caps.InputReportByteLength))
 				{
 					unsigned long j;
+					long button_value = 0;
 
                 	debug_post(LOG_DEBUG,"HidP_GetUsages element %d usage_id %d", i, current_element->usage_id);
                 	debug_post(LOG_DEBUG,"self->inputReportBuffer %p self->caps.InputReportByteLength %d", self->inputReportBuffer, self->caps.InputReportByteLength);
-					current_element->value = 0;
 					// length is set to the number of buttons that are set to ON on the specified usage page
                 	debug_post(LOG_DEBUG,"length = %d (buttons that are ON in this usage page 0x%02X), usages[0]= %d", length, current_element->usage_page, usages[0]);
 
@@ -1247,10 +1258,12 @@ void hidio_get_events(t_hidio *x)
 						if (current_element->usage_id == usages[j])
 						{
                         	debug_post(LOG_DEBUG,"*** HidP_GetUsages element %d", i);
-							current_element->value = 1;
+							button_value = 1;
 							break;
 						}
 					}
+					if (button_value != ELEMENT_VALUE(current_element))
+						hidio_element_update(x, current_element, button_value, report_time);
 				}
 				freebytes(usages, (short)(size * sizeof(unsigned short)));
 			}
@@ -1302,13 +1315,13 @@ t_int hidio_close_device(t_hidio *x)
 			self->fh = INVALID_HANDLE_VALUE;
 
 			/* free element list */
-			for (i = 0; i < element_count[x->x_device_number]; i++)
+			for (i = 0; i < hidio_element_count[x->x_device_number]; i++)
 			{
-				freebytes(element[x->x_device_number][i], sizeof(t_hid_element));
-				element[x->x_device_number][i] = INVALID_HANDLE_VALUE;
+				freebytes(hidio_element_table[x->x_device_number][i], sizeof(t_hid_element));
+				hidio_element_table[x->x_device_number][i] = INVALID_HANDLE_VALUE;
 			}
             
-			element_count[x->x_device_number] = 0;
+			hidio_element_count[x->x_device_number] = 0;
 
 			/* free allocated memory */
 			if (self->inputButtonCaps)
@@ -1347,6 +1360,72 @@ void hidio_print(t_hidio *x)
 }
 
 
+/* input reports always carry every element, so unsubscribed elements
+ * are dropped in hidio_element_update() */
+void hidio_set_event_mask(t_hidio *x)
+{
+	debug_post(LOG_DEBUG,"hidio_set_event_mask");
+}
+
+/* [open-all( and [open-composite( are only implemented on GNU/Linux, there
+ * is no single wait for several overlapped reads here yet */
+t_int hidio_open_multi(t_hidio *x)
+{
+	pd_error(x,"[hidio] open-all and open-composite are not supported on this platform");
+	return 0;
+}
+
+void hidio_close_multi(t_hidio *x)
+{
+}
+
+int hidio_get_ready_multi(t_hidio *x, unsigned char *ready)
+{
+	return 0;
+}
+
+void hidio_select_multi(t_hidio *x, int index)
+{
+}
+
+/* each device is opened on its own here, so a device has no siblings */
+t_int hidio_get_siblings(short device_number, short *siblings)
+{
+	siblings[0] = device_number;
+	return 1;
+}
+
+/* there is no worker thread here yet, [async 1( opens and refreshes right
+ * away like before */
+t_int hidio_async_open(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+t_int hidio_async_refresh(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+t_int hidio_async_done(t_hidio *x)
+{
+	return 1;
+}
+
+t_int hidio_async_finish(t_hidio *x)
+{
+	return EXIT_FAILURE;
+}
+
+void hidio_async_discard(t_hidio *x)
+{
+}
+
+/* tablets are only read as frames on GNU/Linux, nothing is framed here */
+void hidio_output_frame(t_hidio *x)
+{
+}
+
 void hidio_platform_specific_free(t_hidio *x)
 {
 	t_hid_device *self = (t_hid_device *)x->x_hid_device;
@@ -1,42 +1,22 @@
 #ifndef _INPUT_ARRAYS_H
 #define _INPUT_ARRAYS_H
 
+/* generated by make-arrays-from-input.h.pl, do not edit */
 
 extern char *ev[32];
-extern char *ev_syn[512];
-extern char *ev_key[512];
+extern char *ev_syn[16];
+extern char *ev_key[768];
 extern char *ev_rel[16];
 extern char *ev_abs[64];
 extern char *ev_msc[8];
+extern char *ev_sw[17];
 extern char *ev_led[16];
 extern char *ev_snd[8];
 extern char *ev_rep[2];
 extern char *ev_ff[128];
-extern char *ev_pwr[1];
 extern char *ev_ff_status[2];
-extern char *ev_5[16];
-extern char *ev_6[16];
-extern char *ev_7[16];
-extern char *ev_8[16];
-extern char *ev_9[16];
-extern char *ev_10[16];
-extern char *ev_11[16];
-extern char *ev_12[16];
-extern char *ev_13[16];
-extern char *ev_14[16];
-extern char *ev_15[16];
-extern char *ev_16[16];
-extern char *ev_19[16];
-extern char *ev_24[16];
-extern char *ev_25[16];
-extern char *ev_26[16];
-extern char *ev_27[16];
-extern char *ev_28[16];
-extern char *ev_29[16];
-extern char *ev_30[16];
-extern char *ev_31[16];
 extern char **event_names[32];
-
-
+extern int event_names_total[32];
+extern char *event_prefixes[32];
 
 #endif  /* #ifndef _INPUT_ARRAYS_H */
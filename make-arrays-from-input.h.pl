@@ -0,0 +1,205 @@
+#!/usr/bin/perl -w
+#
+# Generates input_arrays.c and input_arrays.h, the names [hidio] uses for
+# the GNU/Linux event types and codes, from the kernel headers:
+#
+#   ./make-arrays-from-input.h.pl [input-event-codes.h input.h]
+#
+# `make input_arrays` runs this, and the GNU/Linux build reruns it when
+# the installed headers are newer than input_arrays.c.  Codes are named
+# after their #define in lower case, except for the names in %names below
+# which [hidio] has always used and patches depend on.  Codes without a
+# #define are NULL, hidio_linux.c makes names like "abs_40" for those.
+
+use strict;
+
+my @headers = @ARGV ? @ARGV : ("/usr/include/linux/input-event-codes.h",
+                               "/usr/include/linux/input.h");
+
+# event types, in the order of linux/input.h, and the prefix of their codes
+my @types = (
+    [ "SYN", "SYN" ], [ "KEY", "KEY|BTN" ], [ "REL", "REL" ], [ "ABS", "ABS" ],
+    [ "MSC", "MSC" ], [ "SW", "SW" ], [ "LED", "LED" ], [ "SND", "SND" ],
+    [ "REP", "REP" ], [ "FF", "FF" ], [ "PWR", "PWR" ],
+    [ "FF_STATUS", "FF_STATUS" ]
+);
+
+my %type_names = ( REL => "relative", ABS => "absolute" );
+
+# the names from before this was generated
+my %names = (
+    KEY_ESC => "escape", KEY_1 => "1_key", KEY_2 => "2_key", KEY_3 => "3_key",
+    KEY_4 => "4_key", KEY_5 => "5_key", KEY_6 => "6_key", KEY_7 => "7_key",
+    KEY_8 => "8_key", KEY_9 => "9_key", KEY_0 => "0_key",
+    KEY_MINUS => "hyphen", KEY_EQUAL => "equalsign",
+    KEY_BACKSPACE => "deleteorbackspace", KEY_TAB => "tab", KEY_Q => "q",
+    KEY_W => "w", KEY_E => "e", KEY_R => "r", KEY_T => "t", KEY_Y => "y",
+    KEY_U => "u", KEY_I => "i", KEY_O => "o", KEY_P => "p",
+    KEY_LEFTCTRL => "leftcontrol", KEY_A => "a", KEY_S => "s", KEY_D => "d",
+    KEY_F => "f", KEY_G => "g", KEY_H => "h", KEY_J => "j", KEY_K => "k",
+    KEY_L => "l", KEY_SEMICOLON => "semicolon", KEY_LEFTSHIFT => "leftshift",
+    KEY_BACKSLASH => "backslash", KEY_Z => "z", KEY_X => "x", KEY_C => "c",
+    KEY_V => "v", KEY_B => "b", KEY_N => "n", KEY_M => "m",
+    KEY_COMMA => "comma", KEY_DOT => "period", KEY_SLASH => "slash",
+    KEY_RIGHTSHIFT => "rightshift", KEY_KPASTERISK => "keypad_asterisk",
+    KEY_LEFTALT => "leftalt", KEY_SPACE => "spacebar",
+    KEY_CAPSLOCK => "capslock", KEY_F1 => "F1", KEY_F2 => "F2",
+    KEY_F3 => "F3", KEY_F4 => "F4", KEY_F5 => "F5", KEY_F6 => "F6",
+    KEY_F7 => "F7", KEY_F8 => "F8", KEY_F9 => "F9", KEY_F10 => "F10",
+    KEY_NUMLOCK => "numlock", KEY_SCROLLLOCK => "scrolllock",
+    KEY_KP7 => "keypad_7", KEY_KP8 => "keypad_8", KEY_KP9 => "keypad_9",
+    KEY_KPMINUS => "keypad_minus", KEY_KP4 => "keypad_4",
+    KEY_KP5 => "keypad_5", KEY_KP6 => "keypad_6", KEY_KPPLUS => "keypad_plus",
+    KEY_KP1 => "keypad_1", KEY_KP2 => "keypad_2", KEY_KP3 => "keypad_3",
+    KEY_KP0 => "keypad_0", KEY_KPDOT => "keypad_dot", KEY_F11 => "F11",
+    KEY_F12 => "F12", KEY_KPJPCOMMA => "keypad_jpcomma",
+    KEY_KPENTER => "keypad_enter", KEY_RIGHTCTRL => "rightcontrol",
+    KEY_KPSLASH => "keypad_slash", KEY_RIGHTALT => "rightalt",
+    KEY_HOME => "home", KEY_UP => "uparrow", KEY_PAGEUP => "pageup",
+    KEY_LEFT => "leftarrow", KEY_RIGHT => "rightarrow", KEY_END => "end",
+    KEY_DOWN => "downarrow", KEY_PAGEDOWN => "pagedown",
+    KEY_INSERT => "insert", KEY_DELETE => "delete", KEY_MACRO => "macro",
+    KEY_MUTE => "mute", KEY_VOLUMEDOWN => "volumedown",
+    KEY_VOLUMEUP => "volumeup", KEY_POWER => "power",
+    KEY_KPEQUAL => "keypad_equal", KEY_KPPLUSMINUS => "keypad_plusminus",
+    KEY_PAUSE => "pause", KEY_KPCOMMA => "keypad_comma",
+    KEY_HANGEUL => "key_hanguel", KEY_LEFTMETA => "leftgui",
+    KEY_RIGHTMETA => "rightgui", KEY_COMPOSE => "compose", KEY_STOP => "stop",
+    KEY_ROTATE_DISPLAY => "key_direction", KEY_CLOSECD => "closecd",
+    KEY_EJECTCD => "ejectcd", KEY_KPLEFTPAREN => "keypad_leftparen",
+    KEY_KPRIGHTPAREN => "keypad_rightparen", KEY_F13 => "F13",
+    KEY_F14 => "F14", KEY_F15 => "F15", KEY_F16 => "F16", KEY_F17 => "F17",
+    KEY_F18 => "F18", KEY_F19 => "F19", KEY_F20 => "F20", KEY_F21 => "F21",
+    KEY_F22 => "F22", KEY_F23 => "F23", KEY_F24 => "F24",
+    BTN_MISC => "button_0", BTN_1 => "button_1", BTN_2 => "button_2",
+    BTN_3 => "button_3", BTN_4 => "button_4", BTN_5 => "button_5",
+    BTN_6 => "button_6", BTN_7 => "button_7", BTN_8 => "button_8",
+    BTN_9 => "button_9", BTN_MOUSE => "btn_left",
+    BTN_JOYSTICK => "btn_trigger", BTN_GAMEPAD => "btn_a",
+    BTN_EAST => "btn_b", BTN_NORTH => "btn_x", BTN_WEST => "btn_y",
+    BTN_DIGI => "btn_tool_pen", BTN_WHEEL => "btn_gear_down",
+    KEY_FULL_SCREEN => "key_zoom", KEY_ASPECT_RATIO => "key_screen",
+    REL_X => "x", REL_Y => "y", REL_Z => "z", REL_RX => "rx", REL_RY => "ry",
+    REL_RZ => "rz", REL_DIAL => "dial", REL_WHEEL => "wheel", ABS_X => "x",
+    ABS_Y => "y", ABS_Z => "z", ABS_RX => "rx", ABS_RY => "ry",
+    ABS_RZ => "rz", ABS_THROTTLE => "throttle", ABS_RUDDER => "rudder",
+    ABS_WHEEL => "wheel", ABS_GAS => "gas", ABS_BRAKE => "brake",
+    ABS_HAT0X => "hat0x", ABS_HAT0Y => "hat0y", ABS_HAT1X => "hat1x",
+    ABS_HAT1Y => "hat1y", ABS_HAT2X => "hat2x", ABS_HAT2Y => "hat2y",
+    ABS_HAT3X => "hat3x", ABS_HAT3Y => "hat3y", ABS_PRESSURE => "pressure",
+    ABS_DISTANCE => "distance", ABS_TILT_X => "tilt_x",
+    ABS_TILT_Y => "tilt_y", ABS_TOOL_WIDTH => "tool_width",
+    ABS_VOLUME => "volume", LED_NUML => "numlock", LED_CAPSL => "capslock",
+    LED_SCROLLL => "scrolllock", LED_COMPOSE => "compose", LED_KANA => "kana",
+    LED_SLEEP => "sleep", LED_SUSPEND => "suspend", LED_MUTE => "mute",
+    LED_MAIL => "mail", LED_CHARGING => "charging", FF_RUMBLE => "rumble",
+    FF_PERIODIC => "periodic", FF_CONSTANT => "constant",
+    FF_SPRING => "spring", FF_FRICTION => "friction", FF_DAMPER => "damper",
+    FF_INERTIA => "inertia", FF_RAMP => "ramp", FF_SQUARE => "square",
+    FF_TRIANGLE => "triangle", FF_SINE => "sine", FF_SAW_UP => "saw_up",
+    FF_SAW_DOWN => "saw_down", FF_GAIN => "gain",
+    FF_AUTOCENTER => "autocenter",
+);
+
+# #defines that are not codes
+my %not_codes = map { $_ => 1 } qw(KEY_MIN_INTERESTING FF_MAX_EFFECTS);
+
+my %value; # of each numeric #define
+my @order; # the #defines in the order they appear
+foreach my $header (@headers) {
+    open(HEADER, "<", $header) or die "$0: can't open $header: $!\n";
+    while (<HEADER>) {
+        next unless /^#define\s+(\w+)\s+(0x[0-9a-fA-F]+|\d+)\b/;
+        my ($define, $number) = ($1, $2);
+        next if exists $value{$define};
+        $value{$define} = ($number =~ /^0x/) ? hex($number) : $number;
+        push(@order, $define);
+    }
+    close(HEADER);
+}
+die "$0: no EV_ types in @headers\n" unless exists $value{"EV_MAX"};
+
+my $ev_count = $value{"EV_MAX"} + 1;
+my (@ev, @tables, @table_names, @table_sizes, @prefixes);
+
+foreach my $type (@types) {
+    my ($name, $prefix) = @$type;
+    next unless exists $value{"EV_$name"};
+    my $number = $value{"EV_$name"};
+    my $lower = lc($name);
+    $ev[$number] = $type_names{$name} || $lower;
+    $prefixes[$number] = $lower;
+
+    # the first #define of each code, later ones are aliases
+    my @codes;
+    foreach my $define (@order) {
+        next unless $define =~ /^($prefix)_/;
+        next if $define =~ /_(MIN|MAX|CNT)$/ || $not_codes{$define};
+        next if ($name eq "FF") && ($define =~ /^FF_STATUS_/);
+        next if defined $codes[$value{$define}];
+        $codes[$value{$define}] = $names{$define} || lc($define);
+    }
+    next unless @codes;
+    my $size = exists $value{"${name}_MAX"} ? $value{"${name}_MAX"} + 1 : scalar(@codes);
+    $size = scalar(@codes) if scalar(@codes) > $size;
+    $#codes = $size - 1;
+    $tables[$number] = \@codes;
+    $table_names[$number] = "ev_$lower";
+    $table_sizes[$number] = $size;
+}
+
+# at most six to a line like the old hand-made arrays
+sub c_array {
+    my @lines;
+    my $line = "";
+    my $count = 0;
+    foreach my $item (@_) {
+        if ($count && (($count == 6) || (length($line) + length($item) > 70))) {
+            push(@lines, "       $line");
+            ($line, $count) = ("", 0);
+        }
+        $line .= ($count++ ? "," : "") . $item;
+    }
+    push(@lines, "       $line") if $count;
+    return join(",\n", @lines) . "\n";
+}
+
+sub c_strings {
+    return c_array(map { defined($_) ? "\"$_\"" : "NULL" } @_);
+}
+
+open(C, ">", "input_arrays.c") or die "$0: can't write input_arrays.c: $!\n";
+print C "/* generated by make-arrays-from-input.h.pl from\n";
+print C " * " . join(" ", map { s|.*/include/||r } @headers) . ", do not edit */\n\n";
+print C "#include \"hidio.h\"\n\n";
+print C "int ev_total = $ev_count;  /* # of elements in array */\n";
+print C "char *ev[$ev_count] = {\n" . c_strings(@ev[0 .. $ev_count - 1]) . " };\n";
+for (my $i = 0; $i < $ev_count; $i++) {
+    next unless defined $tables[$i];
+    print C "\n\n";
+    print C "int $table_names[$i]_total = $table_sizes[$i];  /* # of elements in array */\n";
+    print C "char *$table_names[$i]\[$table_sizes[$i]\] = {\n" . c_strings(@{$tables[$i]}) . " };\n";
+}
+print C "\n\n";
+print C "char **event_names[$ev_count] = {\n" . 
+    c_array(map { defined($_) ? $_ : "NULL" } @table_names[0 .. $ev_count - 1]) . " };\n";
+print C "\n/* the size of each event_names[] array, so codes can be bounds-checked */\n";
+print C "int event_names_total[$ev_count] = {\n" . 
+    c_array(map { defined($_) ? $_ : 0 } @table_sizes[0 .. $ev_count - 1]) . " };\n";
+print C "\n/* the codes that have no name in event_names[] are called <prefix>_<code>,\n";
+print C " * the types without a prefix ev_<type>_<code + 1> */\n";
+print C "char *event_prefixes[$ev_count] = {\n" . c_strings(@prefixes[0 .. $ev_count - 1]) . " };\n";
+close(C);
+
+open(H, ">", "input_arrays.h") or die "$0: can't write input_arrays.h: $!\n";
+print H "#ifndef _INPUT_ARRAYS_H\n#define _INPUT_ARRAYS_H\n\n";
+print H "/* generated by make-arrays-from-input.h.pl, do not edit */\n\n";
+print H "extern char *ev[$ev_count];\n";
+for (my $i = 0; $i < $ev_count; $i++) {
+    print H "extern char *$table_names[$i]\[$table_sizes[$i]\];\n" if defined $tables[$i];
+}
+print H "extern char **event_names[$ev_count];\n";
+print H "extern int event_names_total[$ev_count];\n";
+print H "extern char *event_prefixes[$ev_count];\n";
+print H "\n#endif  /* #ifndef _INPUT_ARRAYS_H */\n";
+close(H);